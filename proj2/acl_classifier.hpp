@@ -0,0 +1,387 @@
+#ifndef ACL_CLASSIFIER_HPP
+#define ACL_CLASSIFIER_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: acl_classifier.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  This class implements a five-tuple access control list used by the
+ *  simulator to drop packets by policy before they are forwarded.
+ *
+ * =============================================================================
+ *  Class: AclClassifier
+ *  ---------------------------------------------------------------------------
+ *  Rule file format (one rule per line, '#' starts a comment):
+ *
+ *      <permit|deny> <src> <dst> <proto> <sport> <dport>
+ *
+ *    - src, dst: a.b.c.d/len, a bare a.b.c.d (= /32) or "any"
+ *    - proto:    tcp, udp, icmp, a number 0-255 or "any"
+ *    - sport, dport: a port, a lo-hi range or "any"
+ *
+ *    Example:
+ *      deny    10.0.0.0/8      any            tcp  any        23
+ *      permit  192.168.0.0/16  10.1.0.0/16    any  any        any
+ *      deny    any             any            udp  1024-65535 53
+ *
+ *  Rules are matched first-match-wins in file order. A packet that matches
+ *  no rule is permitted.
+ *
+ *  ---------------------------------------------------------------------------
+ *  Classification (aggregated bit vectors, Lakshman/Stiliadis + Baboescu):
+ *  Each of the five fields is projected onto the number line and cut into
+ *  elementary intervals at every rule boundary. Every interval stores the
+ *  bit vector of rules whose range covers it, plus a summary vector with
+ *  one bit per 512-rule block (BLOCK_WORDS words) that is non-zero.
+ *  Classifying a packet:
+ *    1. Find each field's interval: a 64K-entry index on the top 16 bits
+ *       narrows the search to the intervals starting in that bucket.
+ *    2. AND the five summary vectors to find blocks where all fields agree.
+ *    3. For those blocks in ascending order, AND the five rule vectors a
+ *       whole block at a time; the first non-zero word's lowest set bit is
+ *       the highest-priority matching rule.
+ *  The cost is five short searches plus the blocks actually touched,
+ *  so 10k-rule lists stay in the millions of lookups per second instead of
+ *  degrading to a linear scan.
+ *
+ *  ---------------------------------------------------------------------------
+ *  Design Notes:
+ *  - proj2 trace records carry only the IPv4 header, so the simulator
+ *    classifies them with both ports set to 0; port-qualified rules only
+ *    match such packets if their range includes port 0.
+ *  - Interval bit vectors for one field are stored back to back in one
+ *    array so a lookup touches a single contiguous row per field.
+ * =============================================================================
+ */
+class AclClassifier
+{
+public:
+    enum class Action : uint8_t
+    {
+        Permit,
+        Deny
+    };
+
+    struct Rule
+    {
+        Action action;
+        uint32_t src_lo, src_hi;
+        uint32_t dst_lo, dst_hi;
+        uint32_t proto_lo, proto_hi;
+        uint32_t sport_lo, sport_hi;
+        uint32_t dport_lo, dport_hi;
+    };
+
+    struct Key
+    {
+        uint32_t src;
+        uint32_t dst;
+        uint8_t proto;
+        uint16_t sport;
+        uint16_t dport;
+    };
+
+    explicit AclClassifier(const std::string &filename)
+    {
+        loadFromFile(filename);
+        build();
+    }
+
+    explicit AclClassifier(const std::vector<Rule> &rules) : rules_(rules)
+    {
+        build();
+    }
+
+    // Returns the index of the first matching rule, or -1 if none matches.
+    int classify(const Key &key) const
+    {
+        if (rules_.empty())
+            return -1;
+
+        const uint32_t values[FIELD_COUNT] = {key.src, key.dst, key.proto, key.sport, key.dport};
+        const uint64_t *rows[FIELD_COUNT];
+        const uint64_t *sums[FIELD_COUNT];
+        for (int f = 0; f < FIELD_COUNT; ++f)
+        {
+            const Field &field = fields_[f];
+            uint32_t bucket = values[f] >> field.shift;
+            auto first = field.starts.begin() + field.index[bucket] + 1;
+            auto last = field.starts.begin() + field.index[bucket + 1] + 1;
+            size_t interval = std::upper_bound(first, last, values[f]) - field.starts.begin() - 1;
+            rows[f] = &field.bits[interval * words_];
+            sums[f] = &field.summary[interval * summary_words_];
+        }
+
+        for (size_t s = 0; s < summary_words_; ++s)
+        {
+            uint64_t blocks = sums[0][s] & sums[1][s] & sums[2][s] & sums[3][s] & sums[4][s];
+            while (blocks)
+            {
+                size_t first = (s * 64 + __builtin_ctzll(blocks)) * BLOCK_WORDS;
+                uint64_t hit[BLOCK_WORDS];
+                uint64_t any = 0;
+                for (size_t i = 0; i < BLOCK_WORDS; ++i)
+                {
+                    size_t w = first + i;
+                    hit[i] = rows[0][w] & rows[1][w] & rows[2][w] & rows[3][w] & rows[4][w];
+                    any |= hit[i];
+                }
+                if (any)
+                {
+                    size_t i = 0;
+                    while (!hit[i])
+                        ++i;
+                    return static_cast<int>((first + i) * 64 + __builtin_ctzll(hit[i]));
+                }
+                blocks &= blocks - 1;
+            }
+        }
+        return -1;
+    }
+
+    bool permits(const Key &key) const
+    {
+        int rule = classify(key);
+        return rule < 0 || rules_[rule].action == Action::Permit;
+    }
+
+    const std::vector<Rule> &rules() const noexcept { return rules_; }
+
+private:
+    static constexpr int FIELD_COUNT = 5;
+    static constexpr size_t BLOCK_WORDS = 8;
+
+    struct Field
+    {
+        int shift;
+        std::vector<uint32_t> index;
+        std::vector<uint32_t> starts;
+        std::vector<uint64_t> bits;
+        std::vector<uint64_t> summary;
+    };
+
+    std::vector<Rule> rules_;
+    std::array<Field, FIELD_COUNT> fields_;
+    size_t words_ = 0;
+    size_t summary_words_ = 0;
+
+    void loadFromFile(const std::string &filename)
+    {
+        std::ifstream file(filename);
+        if (!file.is_open())
+            throw std::runtime_error("Error: cannot open ACL file '" + filename + "'");
+
+        std::string line;
+        int line_no = 0;
+        while (std::getline(file, line))
+        {
+            ++line_no;
+            line = line.substr(0, line.find('#'));
+            std::istringstream in(line);
+            std::string action, src, dst, proto, sport, dport, extra;
+            if (!(in >> action))
+                continue;
+            if (!(in >> src >> dst >> proto >> sport >> dport) || (in >> extra))
+                throw parseError(line_no, "expected 6 fields");
+
+            Rule rule{};
+            if (action == "permit")
+                rule.action = Action::Permit;
+            else if (action == "deny")
+                rule.action = Action::Deny;
+            else
+                throw parseError(line_no, "unknown action '" + action + "'");
+
+            parsePrefix(src, rule.src_lo, rule.src_hi, line_no);
+            parsePrefix(dst, rule.dst_lo, rule.dst_hi, line_no);
+            parseProto(proto, rule.proto_lo, rule.proto_hi, line_no);
+            parsePortRange(sport, rule.sport_lo, rule.sport_hi, line_no);
+            parsePortRange(dport, rule.dport_lo, rule.dport_hi, line_no);
+            rules_.push_back(rule);
+        }
+    }
+
+    static std::runtime_error parseError(int line_no, const std::string &what)
+    {
+        return std::runtime_error("Error: invalid ACL rule at line " + std::to_string(line_no) + " (" + what + ")");
+    }
+
+    static void parsePrefix(const std::string &text, uint32_t &lo, uint32_t &hi, int line_no)
+    {
+        if (text == "any")
+        {
+            lo = 0;
+            hi = 0xFFFFFFFF;
+            return;
+        }
+
+        size_t slash = text.find('/');
+        std::string addr_text = text.substr(0, slash);
+        int plen = 32;
+        if (slash != std::string::npos && !parseNumber(text.substr(slash + 1), 32, plen))
+            throw parseError(line_no, "bad prefix length in '" + text + "'");
+
+        in_addr addr{};
+        if (inet_pton(AF_INET, addr_text.c_str(), &addr) != 1)
+            throw parseError(line_no, "bad address '" + addr_text + "'");
+
+        uint32_t mask = plen == 0 ? 0 : 0xFFFFFFFF << (32 - plen);
+        lo = ntohl(addr.s_addr) & mask;
+        hi = lo | ~mask;
+    }
+
+    static void parseProto(const std::string &text, uint32_t &lo, uint32_t &hi, int line_no)
+    {
+        int proto = 0;
+        if (text == "any")
+        {
+            lo = 0;
+            hi = 255;
+            return;
+        }
+        if (text == "tcp")
+            proto = IPPROTO_TCP;
+        else if (text == "udp")
+            proto = IPPROTO_UDP;
+        else if (text == "icmp")
+            proto = IPPROTO_ICMP;
+        else if (!parseNumber(text, 255, proto))
+            throw parseError(line_no, "bad protocol '" + text + "'");
+        lo = hi = static_cast<uint32_t>(proto);
+    }
+
+    static void parsePortRange(const std::string &text, uint32_t &lo, uint32_t &hi, int line_no)
+    {
+        if (text == "any")
+        {
+            lo = 0;
+            hi = 65535;
+            return;
+        }
+
+        size_t dash = text.find('-');
+        int first = 0, last = 0;
+        bool ok = parseNumber(text.substr(0, dash), 65535, first);
+        last = first;
+        if (ok && dash != std::string::npos)
+            ok = parseNumber(text.substr(dash + 1), 65535, last);
+        if (!ok || first > last)
+            throw parseError(line_no, "bad port range '" + text + "'");
+        lo = static_cast<uint32_t>(first);
+        hi = static_cast<uint32_t>(last);
+    }
+
+    static bool parseNumber(const std::string &text, int max, int &value)
+    {
+        if (text.empty() || text.size() > 5 ||
+            !std::all_of(text.begin(), text.end(), [](char c)
+                         { return c >= '0' && c <= '9'; }))
+            return false;
+        value = std::stoi(text);
+        return value <= max;
+    }
+
+    void build()
+    {
+        size_t blocks = (rules_.size() + 64 * BLOCK_WORDS - 1) / (64 * BLOCK_WORDS);
+        words_ = blocks * BLOCK_WORDS;
+        summary_words_ = (blocks + 63) / 64;
+
+        buildField(fields_[0], &Rule::src_lo, &Rule::src_hi, 32);
+        buildField(fields_[1], &Rule::dst_lo, &Rule::dst_hi, 32);
+        buildField(fields_[2], &Rule::proto_lo, &Rule::proto_hi, 8);
+        buildField(fields_[3], &Rule::sport_lo, &Rule::sport_hi, 16);
+        buildField(fields_[4], &Rule::dport_lo, &Rule::dport_hi, 16);
+    }
+
+    /*
+     * Sweeps the rule boundaries of one field in order, keeping the bit vector
+     * of rules active at the sweep point, and snapshots it for every interval.
+     */
+    void buildField(Field &field, uint32_t Rule::*lo, uint32_t Rule::*hi, int field_bits)
+    {
+        // (position, rule index): rule becomes active at lo and inactive after hi.
+        std::vector<std::pair<uint64_t, size_t>> opens, closes;
+        opens.reserve(rules_.size());
+        closes.reserve(rules_.size());
+        for (size_t r = 0; r < rules_.size(); ++r)
+        {
+            opens.emplace_back(rules_[r].*lo, r);
+            closes.emplace_back(static_cast<uint64_t>(rules_[r].*hi) + 1, r);
+        }
+        std::sort(opens.begin(), opens.end());
+        std::sort(closes.begin(), closes.end());
+
+        std::vector<uint64_t> active(words_, 0);
+        size_t next_open = 0, next_close = 0;
+        uint64_t position = 0;
+        while (position <= 0xFFFFFFFFULL)
+        {
+            while (next_close < closes.size() && closes[next_close].first == position)
+            {
+                size_t r = closes[next_close++].second;
+                active[r / 64] &= ~(1ULL << (r % 64));
+            }
+            while (next_open < opens.size() && opens[next_open].first == position)
+            {
+                size_t r = opens[next_open++].second;
+                active[r / 64] |= 1ULL << (r % 64);
+            }
+
+            field.starts.push_back(static_cast<uint32_t>(position));
+            field.bits.insert(field.bits.end(), active.begin(), active.end());
+            std::vector<uint64_t> summary(summary_words_, 0);
+            for (size_t w = 0; w < words_; ++w)
+                if (active[w])
+                    summary[w / BLOCK_WORDS / 64] |= 1ULL << (w / BLOCK_WORDS % 64);
+            field.summary.insert(field.summary.end(), summary.begin(), summary.end());
+
+            uint64_t next = 0x100000000ULL;
+            if (next_open < opens.size())
+                next = std::min(next, opens[next_open].first);
+            if (next_close < closes.size())
+                next = std::min(next, closes[next_close].first);
+            position = next;
+        }
+
+        buildIndex(field, field_bits);
+    }
+
+    /*
+     * index[b] is the interval holding the first value of bucket b (the top
+     * 16 bits of the field), so a lookup only binary searches the intervals
+     * that start inside its own bucket. Fields of 16 bits or less resolve
+     * directly from the index.
+     */
+    static void buildIndex(Field &field, int field_bits)
+    {
+        field.shift = std::max(0, field_bits - 16);
+        size_t buckets = size_t{1} << (field_bits - field.shift);
+        field.index.resize(buckets + 1);
+
+        size_t interval = 0;
+        for (size_t b = 0; b < buckets; ++b)
+        {
+            uint64_t bucket_start = static_cast<uint64_t>(b) << field.shift;
+            while (interval + 1 < field.starts.size() && field.starts[interval + 1] <= bucket_start)
+                ++interval;
+            field.index[b] = static_cast<uint32_t>(interval);
+        }
+        field.index[buckets] = static_cast<uint32_t>(field.starts.size() - 1);
+    }
+};
+
+#endif
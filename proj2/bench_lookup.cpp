@@ -0,0 +1,595 @@
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: bench_lookup.cpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  Lookup benchmark and differential checker for the ForwardingTable
+ *  engines. For every table size it generates a BGP-like synthetic table
+ *  (see synthetic_table.hpp), builds each engine from it, and reports:
+ *   - build time and memory growth of the engine, and with -H the page
+ *     size backing its largest arrays (huge_pages.hpp),
+ *   - lookups/sec and ns/lookup percentiles for the uniform, Zipf and
+ *     sequential destination streams,
+ *   - whether every lookup agreed with ReferenceTable, the original nested
+ *     hash-table implementation kept here as the ground truth.
+ *  A second section times destination reordering (batch_reorder.hpp, proj2
+ *  -s -R): windows of 256 to 16384 destinations looked up in arrival order
+ *  against the same window radix-sorted by destination and looked up once
+ *  per distinct destination, sort cost included, for the hash, spec and VRF
+ *  trie engines. "lookups" is the share of table probes the sorted order
+ *  still makes; both orders must give the same results.
+ *  Afterwards it times proj2 -s output formatting: the original
+ *  fixed/setprecision iostream path against the packet_verdict.hpp
+ *  formatter, checking that both produce the same bytes.
+ *
+ * Usage:
+ *   ./bench_lookup [-n prefixes] [-l lookups] [-s seed] [-w table_file] [-H]
+ *   Without -n the sizes 1k, 10k, 100k and 1M are run in turn. With -w the
+ *   synthetic table of size -n is written in forwarding-file format and the
+ *   program exits, so the same table can be fed to proj2. Comparing runs
+ *   with and without -H shows what huge pages save in TLB misses.
+ *   Exit status is 1 if any engine disagrees with the reference, reordered
+ *   lookups disagree with plain ones, or the formatters disagree.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <cstdlib>
+#include <malloc.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "forwarding_table.hpp"
+#include "synthetic_table.hpp"
+#include "packet_verdict.hpp"
+#include "huge_pages.hpp"
+#include "vrf_table.hpp"
+#include "batch_reorder.hpp"
+
+using namespace std;
+
+struct BenchArgs
+{
+    vector<size_t> sizes = {1'000, 10'000, 100'000, 1'000'000};
+    size_t lookups = 2'000'000;
+    uint64_t seed = 1;
+    string write_file;
+    bool huge_pages = false;
+};
+
+struct LookupStats
+{
+    double mlookups_per_sec = 0;
+    double p50_ns = 0;
+    double p90_ns = 0;
+    double p99_ns = 0;
+    double p999_ns = 0;
+};
+
+/*
+ * The lookup semantics of the original ForwardingTable: one unordered_map per
+ * prefix length, probed from /32 down, with 0.0.0.0 entries also acting as
+ * the default route. Engines are compared against this and nothing else.
+ */
+class ReferenceTable
+{
+public:
+    explicit ReferenceTable(const vector<ForwardingTable::Entry> &entries)
+    {
+        for (auto e : entries)
+        {
+            if (e.addr == 0)
+            {
+                e.prefix_len = 8;
+                default_iface_ = e.iface;
+            }
+            tables_[e.prefix_len][e.addr & syntheticPrefixMask(e.prefix_len)] = e.iface;
+        }
+    }
+
+    int lookup(uint32_t dest_ip, bool &is_default) const
+    {
+        for (int plen : {32, 24, 16, 8})
+        {
+            auto table = tables_.find(plen);
+            if (table == tables_.end())
+                continue;
+            auto it = table->second.find(dest_ip & syntheticPrefixMask(plen));
+            if (it != table->second.end())
+            {
+                is_default = false;
+                return it->second;
+            }
+        }
+
+        is_default = default_iface_ >= 0;
+        return default_iface_;
+    }
+
+private:
+    unordered_map<int, unordered_map<uint32_t, uint16_t>> tables_;
+    int default_iface_ = -1;
+};
+
+void usage(const char *progname)
+{
+    cerr << "Usage: " << progname << " [-n prefixes] [-l lookups] [-s seed] [-w table_file] [-H]\n"
+         << "  -n : Table size (default: 1000, 10000, 100000 and 1000000)\n"
+         << "  -l : Lookups per destination stream (default 2000000)\n"
+         << "  -s : Random seed (default 1)\n"
+         << "  -w : Write the synthetic table of size -n to table_file and exit\n"
+         << "  -H : Back large table arrays with huge pages\n";
+    exit(EXIT_FAILURE);
+}
+
+void parseArgs(int argc, char *argv[], BenchArgs &args)
+{
+    bool size_given = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:l:s:w:H")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            if (!size_given)
+                args.sizes.clear();
+            size_given = true;
+            args.sizes.push_back(strtoull(optarg, nullptr, 10));
+            break;
+        case 'l':
+            args.lookups = strtoull(optarg, nullptr, 10);
+            break;
+        case 's':
+            args.seed = strtoull(optarg, nullptr, 10);
+            break;
+        case 'w':
+            args.write_file = optarg;
+            break;
+        case 'H':
+            args.huge_pages = true;
+            break;
+        default:
+            usage(argv[0]);
+        }
+    }
+
+    if (args.lookups == 0 || (!args.write_file.empty() && args.sizes.size() != 1))
+        usage(argv[0]);
+}
+
+void writeTableFile(const string &filename, const vector<ForwardingTable::Entry> &entries)
+{
+    ofstream out(filename, ios::binary);
+    if (!out.is_open())
+    {
+        cerr << "Error: Cannot open file '" << filename << "'\n";
+        exit(EXIT_FAILURE);
+    }
+
+    for (const auto &e : entries)
+    {
+        ForwardingTable::Entry wire{htonl(e.addr), htons(e.prefix_len), htons(e.iface)};
+        out.write(reinterpret_cast<const char *>(&wire), sizeof(wire));
+    }
+}
+
+size_t heapInUse()
+{
+    struct mallinfo2 mi = mallinfo2();
+    return mi.uordblks + mi.hblkhd;
+}
+
+// Heap plus the regions HugePages mapped itself, and the backing of most of
+// the latter.
+size_t memoryInUse(PageBacking &largest)
+{
+    HugePages::Usage usage = HugePages::usage();
+    size_t mapped = 0;
+    largest = PageBacking::Heap;
+    for (int b = 0; b < HugePages::BACKINGS; ++b)
+    {
+        mapped += usage.bytes[b];
+        if (usage.bytes[b] > usage.bytes[static_cast<int>(largest)])
+            largest = static_cast<PageBacking>(b);
+    }
+    return heapInUse() + mapped;
+}
+
+vector<uint32_t> boundaryProbes(const vector<ForwardingTable::Entry> &entries)
+{
+    vector<uint32_t> probes;
+    probes.reserve(entries.size() * 4);
+    for (const auto &e : entries)
+    {
+        uint32_t mask = syntheticPrefixMask(e.prefix_len);
+        uint32_t first = e.addr & mask;
+        uint32_t last = first | ~mask;
+        probes.insert(probes.end(), {first, last, first - 1, last + 1});
+    }
+    return probes;
+}
+
+template <typename Table>
+size_t countMismatches(const Table &table, const ReferenceTable &reference,
+                       const vector<uint32_t> &probes, uint32_t &first_bad)
+{
+    size_t mismatches = 0;
+    for (uint32_t ip : probes)
+    {
+        bool want_default = false, got_default = false;
+        int want = reference.lookup(ip, want_default);
+        int got = table.lookup(ip, got_default);
+        if (want != got || want_default != got_default)
+        {
+            if (mismatches++ == 0)
+                first_bad = ip;
+        }
+    }
+    return mismatches;
+}
+
+template <typename Table>
+LookupStats measureLookups(const Table &table, const vector<uint32_t> &dests)
+{
+    constexpr size_t BATCH = 256;
+    using clock = chrono::steady_clock;
+
+    // Warm the caches and branch predictors on the same stream.
+    volatile int sink = 0;
+    for (size_t i = 0; i < min<size_t>(dests.size(), 1 << 16); ++i)
+    {
+        bool is_default;
+        sink = sink + table.lookup(dests[i], is_default);
+    }
+
+    vector<double> per_lookup_ns;
+    per_lookup_ns.reserve(dests.size() / BATCH + 1);
+
+    int acc = 0;
+    auto start = clock::now();
+    for (size_t base = 0; base + BATCH <= dests.size(); base += BATCH)
+    {
+        auto t0 = clock::now();
+        for (size_t i = base; i < base + BATCH; ++i)
+        {
+            bool is_default;
+            acc += table.lookup(dests[i], is_default);
+        }
+        auto t1 = clock::now();
+        per_lookup_ns.push_back(chrono::duration<double, nano>(t1 - t0).count() / BATCH);
+    }
+    auto elapsed = chrono::duration<double>(clock::now() - start).count();
+    sink = sink + acc;
+
+    LookupStats stats;
+    if (per_lookup_ns.empty())
+        return stats;
+
+    stats.mlookups_per_sec = per_lookup_ns.size() * BATCH / elapsed / 1e6;
+    sort(per_lookup_ns.begin(), per_lookup_ns.end());
+    auto pct = [&](double p)
+    { return per_lookup_ns[min(per_lookup_ns.size() - 1, static_cast<size_t>(p * per_lookup_ns.size()))]; };
+    stats.p50_ns = pct(0.50);
+    stats.p90_ns = pct(0.90);
+    stats.p99_ns = pct(0.99);
+    stats.p999_ns = pct(0.999);
+    return stats;
+}
+
+void printHeader()
+{
+    cout << left << setw(9) << "prefixes" << setw(10) << "engine" << setw(12) << "pattern"
+         << right << setw(10) << "build_ms" << setw(11) << "mem_KiB" << setw(8) << "pages" << setw(11) << "Mlookup/s"
+         << setw(8) << "p50_ns" << setw(8) << "p90_ns" << setw(8) << "p99_ns" << setw(10) << "p99.9_ns"
+         << "  check\n";
+}
+
+template <typename Build>
+bool benchEngine(const char *name, Build build, const vector<ForwardingTable::Entry> &entries,
+                 const ReferenceTable &reference, const vector<uint32_t> &boundaries,
+                 const vector<pair<DestPattern, vector<uint32_t>>> &streams)
+{
+    PageBacking backing;
+    size_t memory_before = memoryInUse(backing);
+    auto t0 = chrono::steady_clock::now();
+    auto table = build(entries);
+    auto t1 = chrono::steady_clock::now();
+    size_t memory_bytes = memoryInUse(backing) - memory_before;
+    double build_ms = chrono::duration<double, milli>(t1 - t0).count();
+
+    bool ok = true;
+    uint32_t first_bad = 0;
+    size_t boundary_bad = countMismatches(table, reference, boundaries, first_bad);
+
+    for (const auto &[pattern, dests] : streams)
+    {
+        size_t bad = boundary_bad + countMismatches(table, reference, dests, first_bad);
+        LookupStats stats = measureLookups(table, dests);
+
+        cout << left << setw(9) << entries.size() << setw(10) << name << setw(12) << destPatternName(pattern)
+             << right << fixed << setprecision(1)
+             << setw(10) << build_ms << setw(11) << memory_bytes / 1024 << setw(8) << pageBackingName(backing)
+             << setprecision(2) << setw(11) << stats.mlookups_per_sec
+             << setprecision(1) << setw(8) << stats.p50_ns << setw(8) << stats.p90_ns
+             << setw(8) << stats.p99_ns << setw(10) << stats.p999_ns;
+        if (bad == 0)
+        {
+            cout << "  ok\n";
+        }
+        else
+        {
+            in_addr addr{htonl(first_bad)};
+            cout << "  MISMATCH " << bad << " (first " << inet_ntoa(addr) << ")\n";
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+bool runSize(size_t count, const BenchArgs &args)
+{
+    vector<ForwardingTable::Entry> entries = generateSyntheticTable(count, args.seed);
+    ReferenceTable reference(entries);
+    vector<uint32_t> boundaries = boundaryProbes(entries);
+
+    vector<pair<DestPattern, vector<uint32_t>>> streams;
+    for (DestPattern pattern : {DestPattern::Uniform, DestPattern::Zipf, DestPattern::Sequential})
+        streams.emplace_back(pattern, generateDestinations(entries, pattern, args.lookups, args.seed + 1));
+
+    bool ok = true;
+    ok &= benchEngine(
+        "hash", [](const auto &e)
+        { return ForwardingTable(e); },
+        entries, reference, boundaries, streams);
+    ok &= benchEngine(
+        "bloom", [](const auto &e)
+        { return ForwardingTable(e, ForwardingTable::LookupEngine::Bloom); },
+        entries, reference, boundaries, streams);
+    ok &= benchEngine(
+        "bsl", [](const auto &e)
+        { return ForwardingTable(e, ForwardingTable::LookupEngine::LengthSearch); },
+        entries, reference, boundaries, streams);
+    ok &= benchEngine(
+        "spec", [](const auto &e)
+        { return ForwardingTable(e, ForwardingTable::LookupEngine::Specialized); },
+        entries, reference, boundaries, streams);
+    return ok;
+}
+
+// The VRF trie as a single table, so it fits the engine templates.
+class TrieTable
+{
+public:
+    explicit TrieTable(const ForwardingTable &table) { trie_.addVrf(table); }
+
+    int lookup(uint32_t dest_ip, bool &is_default) const { return trie_.lookup(0, dest_ip, is_default); }
+
+private:
+    VrfForwardingTable trie_;
+};
+
+/*
+ * Looks up dests in windows, in arrival order or, like proj2 -s -R, in the
+ * order DestinationOrder puts each window in with one lookup per distinct
+ * destination, writing every result to its arrival position. Returns
+ * Mlookups/s (packets resolved, not table probes); lookups counts the
+ * table probes made.
+ */
+template <typename Table>
+double timeWindows(const Table &table, const vector<uint32_t> &dests, size_t window, bool reorder,
+                   vector<int> &results, size_t &lookups)
+{
+    DestinationOrder order;
+    results.assign(dests.size(), 0);
+    lookups = 0;
+
+    auto start = chrono::steady_clock::now();
+    for (size_t base = 0; base + window <= dests.size(); base += window)
+    {
+        if (reorder)
+        {
+            vector<DestinationOrder::Item> &items = order.items();
+            items.clear();
+            for (size_t i = base; i < base + window; ++i)
+                items.push_back({dests[i], static_cast<uint32_t>(i)});
+            order.sort();
+
+            int result = 0;
+            for (size_t k = 0; k < items.size(); ++k)
+            {
+                if (k == 0 || items[k].dest != items[k - 1].dest)
+                {
+                    bool is_default;
+                    result = table.lookup(items[k].dest, is_default);
+                    ++lookups;
+                }
+                results[items[k].index] = result;
+            }
+        }
+        else
+        {
+            for (size_t i = base; i < base + window; ++i)
+            {
+                bool is_default;
+                results[i] = table.lookup(dests[i], is_default);
+            }
+            lookups += window;
+        }
+    }
+    auto elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return dests.size() / window * window / elapsed / 1e6;
+}
+
+// From proj2's PIPELINE_BATCH up to the largest -R window.
+constexpr size_t REORDER_WINDOWS[] = {256, 1024, 4096, 16384};
+
+template <typename Table>
+bool benchReorderEngine(const char *name, const Table &table, size_t prefixes,
+                        const vector<pair<DestPattern, vector<uint32_t>>> &streams)
+{
+    bool ok = true;
+    vector<int> plain, sorted;
+    size_t plain_lookups, sorted_lookups;
+    for (const auto &[pattern, dests] : streams)
+    {
+        for (size_t window : REORDER_WINDOWS)
+        {
+            // One untimed pass of each to warm the table and the buffers,
+            // then the better of three timed passes.
+            double plain_rate = 0, sorted_rate = 0;
+            for (int pass = 0; pass < 4; ++pass)
+            {
+                double p = timeWindows(table, dests, window, false, plain, plain_lookups);
+                double r = timeWindows(table, dests, window, true, sorted, sorted_lookups);
+                if (pass > 0)
+                {
+                    plain_rate = max(plain_rate, p);
+                    sorted_rate = max(sorted_rate, r);
+                }
+            }
+            bool same = plain == sorted;
+            ok &= same;
+
+            cout << left << setw(9) << prefixes << setw(10) << name << setw(12) << destPatternName(pattern)
+                 << right << setw(7) << window << fixed << setprecision(1)
+                 << setw(10) << 100.0 * sorted_lookups / plain_lookups << "%" << setprecision(2)
+                 << setw(11) << plain_rate << setw(12) << sorted_rate << setw(9) << sorted_rate / plain_rate << "x"
+                 << (same ? "  ok\n" : "  MISMATCH\n");
+        }
+    }
+    return ok;
+}
+
+bool benchReorder(const BenchArgs &args)
+{
+    cout << "\n"
+         << left << setw(9) << "prefixes" << setw(10) << "engine" << setw(12) << "pattern"
+         << right << setw(7) << "window" << setw(11) << "lookups" << setw(11) << "plain_Ml/s" << setw(12) << "sorted_Ml/s" << setw(10) << "speedup" << "  check\n";
+
+    bool ok = true;
+    for (size_t count : args.sizes)
+    {
+        vector<ForwardingTable::Entry> entries = generateSyntheticTable(count, args.seed);
+        vector<pair<DestPattern, vector<uint32_t>>> streams;
+        for (DestPattern pattern : {DestPattern::Uniform, DestPattern::Zipf, DestPattern::Hosts})
+            streams.emplace_back(pattern, generateDestinations(entries, pattern, args.lookups, args.seed + 1));
+
+        ForwardingTable hash(entries);
+        ok &= benchReorderEngine("hash", hash, count, streams);
+        ForwardingTable spec(entries, ForwardingTable::LookupEngine::Specialized);
+        ok &= benchReorderEngine("spec", spec, count, streams);
+        TrieTable trie(hash);
+        ok &= benchReorderEngine("trie", trie, count, streams);
+    }
+    return ok;
+}
+
+struct FormatSample
+{
+    uint32_t sec;
+    uint32_t usec;
+    PacketVerdict verdict;
+};
+
+vector<FormatSample> generateFormatSamples(size_t count, uint64_t seed)
+{
+    mt19937_64 rng(seed);
+    vector<FormatSample> samples(count);
+    for (auto &sample : samples)
+    {
+        // Mostly trace-like timestamps, plus full-range seconds and
+        // out-of-range microseconds to exercise the carry.
+        uint64_t r = rng();
+        sample.sec = (r & 7) == 0 ? static_cast<uint32_t>(rng()) : 1'700'000'000 + static_cast<uint32_t>(rng() % 86'400);
+        sample.usec = (r & 0x38) == 0 ? static_cast<uint32_t>(rng()) : static_cast<uint32_t>(rng() % 1'000'000);
+        sample.verdict.action = static_cast<PacketAction>(1 + (r >> 8) % 6);
+        sample.verdict.iface = static_cast<uint16_t>(rng());
+    }
+    return samples;
+}
+
+// The per-packet strings simulatePackets used to build.
+string legacyAction(PacketVerdict verdict)
+{
+    switch (verdict.action)
+    {
+    case PacketAction::DropChecksum:
+        return "drop checksum";
+    case PacketAction::DropExpired:
+        return "drop expired";
+    case PacketAction::DropPolicy:
+        return "drop policy";
+    case PacketAction::Send:
+        return "send " + to_string(verdict.iface);
+    case PacketAction::Default:
+        return "default " + to_string(verdict.iface);
+    default:
+        return "drop unknown";
+    }
+}
+
+bool benchFormat(const BenchArgs &args)
+{
+    using clock = chrono::steady_clock;
+    vector<FormatSample> samples = generateFormatSamples(args.lookups, args.seed);
+
+    auto t0 = clock::now();
+    ostringstream legacy;
+    legacy << fixed << setprecision(6);
+    for (const auto &sample : samples)
+    {
+        double timestamp = static_cast<double>(sample.sec) + static_cast<double>(sample.usec) / 1'000'000.0;
+        legacy << timestamp << " " << legacyAction(sample.verdict) << "\n";
+    }
+    string legacy_text = legacy.str();
+    auto t1 = clock::now();
+
+    string fast_text(samples.size() * MAX_VERDICT_LINE, '\0');
+    char *out = fast_text.data();
+    for (const auto &sample : samples)
+        out = formatVerdictLine(out, sample.sec, sample.usec, sample.verdict);
+    fast_text.resize(static_cast<size_t>(out - fast_text.data()));
+    auto t2 = clock::now();
+
+    double legacy_rate = samples.size() / chrono::duration<double>(t1 - t0).count() / 1e6;
+    double fast_rate = samples.size() / chrono::duration<double>(t2 - t1).count() / 1e6;
+    bool ok = legacy_text == fast_text;
+
+    cout << "\n"
+         << left << setw(10) << "lines" << right << setw(16) << "iostream_Ml/s" << setw(12) << "fast_Ml/s"
+         << setw(10) << "speedup" << "  check\n"
+         << left << setw(10) << samples.size() << right << fixed << setprecision(2)
+         << setw(16) << legacy_rate << setw(12) << fast_rate << setw(9) << fast_rate / legacy_rate << "x"
+         << (ok ? "  ok\n" : "  MISMATCH\n");
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    BenchArgs args;
+    parseArgs(argc, argv, args);
+
+    if (!args.write_file.empty())
+    {
+        writeTableFile(args.write_file, generateSyntheticTable(args.sizes.front(), args.seed));
+        return 0;
+    }
+
+    HugePages::configure(args.huge_pages);
+    printHeader();
+    bool ok = true;
+    for (size_t count : args.sizes)
+        ok &= runSize(count, args);
+    ok &= benchReorder(args);
+    ok &= benchFormat(args);
+
+    return ok ? 0 : 1;
+}
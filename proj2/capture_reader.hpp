@@ -0,0 +1,467 @@
+#ifndef CAPTURE_READER_HPP
+#define CAPTURE_READER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "trace_record.hpp"
+
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: capture_reader.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  Reads pcap and pcapng capture files directly (no libpcap) and turns
+ *  every IPv4 packet in them into the TraceRecord proj2 simulates, so real
+ *  captures can be fed to proj2 without converting them first.
+ *
+ * =============================================================================
+ *  Class: CaptureReader
+ *  ---------------------------------------------------------------------------
+ *  - The file is mmap()ed and walked in place: for each packet only the
+ *    20-byte IPv4 header is copied, straight into the caller's record.
+ *  - pcap: a 24-byte file header (magic a1b2c3d4 for microsecond or
+ *    a1b23c4d for nanosecond timestamps, in either byte order, then the
+ *    link type) followed by 16-byte record headers and packet data.
+ *  - pcapng: a sequence of blocks. Section headers set the byte order and
+ *    reset the interface list; interface descriptions give each interface
+ *    its link type and timestamp resolution (if_tsresol, microseconds by
+ *    default); enhanced and simple packet blocks carry the packets (simple
+ *    ones have no timestamp and read as time 0). Other blocks are skipped.
+ *  - Link types: Ethernet, with any number of 802.1Q / 802.1ad VLAN tags,
+ *    Linux cooked capture, and raw IP. Packets that are not IPv4, have less
+ *    than a full IPv4 header captured, or arrive on an interface with
+ *    another link type are counted as skipped.
+ *  - Timestamps are converted to whole seconds and microseconds, truncating
+ *    finer resolutions.
+ *  - A packet or block cut short by the end of the file ends the capture,
+ *    as a trailing partial record ends a trace file.
+ * =============================================================================
+ */
+class CaptureReader
+{
+public:
+    enum class Format
+    {
+        Pcap,
+        PcapNg
+    };
+
+    // True if the file starts like a pcap or pcapng capture. Files that
+    // cannot be read at offset 0 (pipes) are never taken for captures.
+    static bool isCapture(const std::string &filename)
+    {
+        int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+        unsigned char head[12];
+        ssize_t got = pread(fd, head, sizeof(head), 0);
+        close(fd);
+        return got == static_cast<ssize_t>(sizeof(head)) && detect(head).first;
+    }
+
+    explicit CaptureReader(const std::string &filename)
+    {
+        int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            throw std::runtime_error("Error: cannot open capture file '" + filename + "'");
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < 12)
+        {
+            close(fd);
+            throw std::runtime_error("Error: '" + filename + "' is not a pcap or pcapng capture");
+        }
+
+        size_ = static_cast<size_t>(st.st_size);
+        void *map = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED)
+            throw std::runtime_error("Error: cannot map capture file '" + filename + "'");
+        data_ = static_cast<const unsigned char *>(map);
+        madvise(map, size_, MADV_SEQUENTIAL);
+
+        try
+        {
+            readFileHeader(filename);
+        }
+        catch (...)
+        {
+            munmap(const_cast<unsigned char *>(data_), size_);
+            throw;
+        }
+    }
+
+    ~CaptureReader() { munmap(const_cast<unsigned char *>(data_), size_); }
+
+    CaptureReader(const CaptureReader &) = delete;
+    CaptureReader &operator=(const CaptureReader &) = delete;
+
+    // Stores the next (at most max) IPv4 packets in out, fields in network
+    // byte order as in a trace file. Returns fewer than max only once the
+    // capture is exhausted.
+    size_t read(TraceRecord *out, size_t max)
+    {
+        return format_ == Format::Pcap ? readPackets<&CaptureReader::nextPcapPacket>(out, max)
+                                       : readPackets<&CaptureReader::nextPcapNgPacket>(out, max);
+    }
+
+    Format format() const noexcept { return format_; }
+    const char *formatName() const noexcept { return format_ == Format::Pcap ? "pcap" : "pcapng"; }
+
+    // Packet records read so far, and how many of them were not usable IPv4.
+    uint64_t packets() const noexcept { return packets_; }
+    uint64_t skipped() const noexcept { return skipped_; }
+
+private:
+    static constexpr uint32_t PCAP_MICRO = 0xA1B2C3D4;
+    static constexpr uint32_t PCAP_NANO = 0xA1B23C4D;
+    static constexpr uint32_t NG_SECTION = 0x0A0D0D0A;
+    static constexpr uint32_t NG_BYTE_ORDER = 0x1A2B3C4D;
+    static constexpr uint32_t NG_INTERFACE = 1;
+    static constexpr uint32_t NG_SIMPLE_PACKET = 3;
+    static constexpr uint32_t NG_ENHANCED_PACKET = 6;
+    static constexpr uint16_t NG_OPT_TSRESOL = 9;
+
+    static constexpr uint16_t LINK_ETHERNET = 1;
+    static constexpr uint16_t LINK_RAW = 101;
+    static constexpr uint16_t LINK_LINUX_SLL = 113;
+    static constexpr uint16_t LINK_IPV4 = 228;
+    static constexpr uint16_t LINK_UNSUPPORTED = 0xFFFF;
+
+    static constexpr size_t PCAP_FILE_HEADER = 24;
+    static constexpr size_t PCAP_RECORD_HEADER = 16;
+    static constexpr size_t IPV4_HEADER = 20;
+
+    struct Interface
+    {
+        uint16_t link_type;
+        // Timestamp units per second, and its log2 if that is a power of
+        // two small enough for the fraction to be scaled in 64 bits.
+        uint64_t resolution;
+        int shift;
+    };
+
+    struct Packet
+    {
+        const unsigned char *data;
+        uint32_t length;
+        uint16_t link_type;
+        uint32_t sec;
+        uint32_t usec;
+    };
+
+    const unsigned char *data_ = nullptr;
+    size_t size_ = 0;
+    size_t cursor_ = 0;
+    Format format_ = Format::Pcap;
+    bool swapped_ = false;
+    bool nanosecond_ = false;
+    uint16_t link_type_ = LINK_UNSUPPORTED;
+    std::vector<Interface> interfaces_;
+    uint64_t packets_ = 0;
+    uint64_t skipped_ = 0;
+
+    // (is a capture, format) from the first 12 bytes of a file.
+    static std::pair<bool, Format> detect(const unsigned char *head)
+    {
+        uint32_t magic;
+        std::memcpy(&magic, head, sizeof(magic));
+        if (magic == PCAP_MICRO || magic == PCAP_NANO ||
+            magic == __builtin_bswap32(PCAP_MICRO) || magic == __builtin_bswap32(PCAP_NANO))
+            return {true, Format::Pcap};
+
+        uint32_t order;
+        std::memcpy(&order, head + 8, sizeof(order));
+        if (magic == NG_SECTION && (order == NG_BYTE_ORDER || order == __builtin_bswap32(NG_BYTE_ORDER)))
+            return {true, Format::PcapNg};
+        return {false, Format::Pcap};
+    }
+
+    uint16_t u16(size_t offset) const noexcept
+    {
+        uint16_t value;
+        std::memcpy(&value, data_ + offset, sizeof(value));
+        return swapped_ ? __builtin_bswap16(value) : value;
+    }
+
+    uint32_t u32(size_t offset) const noexcept
+    {
+        uint32_t value;
+        std::memcpy(&value, data_ + offset, sizeof(value));
+        return swapped_ ? __builtin_bswap32(value) : value;
+    }
+
+    static bool supported(uint16_t link_type)
+    {
+        return link_type == LINK_ETHERNET || link_type == LINK_RAW || link_type == LINK_LINUX_SLL ||
+               link_type == LINK_IPV4;
+    }
+
+    void readFileHeader(const std::string &filename)
+    {
+        auto [capture, format] = detect(data_);
+        if (!capture)
+            throw std::runtime_error("Error: '" + filename + "' is not a pcap or pcapng capture");
+        format_ = format;
+        if (format_ == Format::PcapNg)
+            return;
+
+        uint32_t magic;
+        std::memcpy(&magic, data_, sizeof(magic));
+        swapped_ = magic != PCAP_MICRO && magic != PCAP_NANO;
+        nanosecond_ = u32(0) == PCAP_NANO;
+        if (size_ < PCAP_FILE_HEADER)
+            throw std::runtime_error("Error: capture file '" + filename + "' is truncated");
+
+        // The link type is the low 16 bits; the upper ones are FCS flags.
+        link_type_ = static_cast<uint16_t>(u32(20));
+        if (!supported(link_type_))
+            throw std::runtime_error("Error: unsupported link type " + std::to_string(link_type_) +
+                                     " in capture '" + filename + "'");
+        cursor_ = PCAP_FILE_HEADER;
+    }
+
+    // The format is fixed per file, so each gets its own copy of the loop.
+    template <bool (CaptureReader::*Next)(Packet &)>
+    size_t readPackets(TraceRecord *out, size_t max)
+    {
+        size_t count = 0;
+        Packet packet;
+        while (count < max && (this->*Next)(packet))
+        {
+            ++packets_;
+            const unsigned char *ip = ipv4Header(packet);
+            if (!ip)
+            {
+                ++skipped_;
+                continue;
+            }
+
+            TraceRecord &record = out[count++];
+            record.sec = htonl(packet.sec);
+            record.usec = htonl(packet.usec);
+            std::memcpy(&record.hdr, ip, sizeof(record.hdr));
+        }
+        return count;
+    }
+
+    bool nextPcapPacket(Packet &packet)
+    {
+        if (size_ - cursor_ < PCAP_RECORD_HEADER)
+            return false;
+        uint32_t captured = u32(cursor_ + 8);
+        if (size_ - cursor_ - PCAP_RECORD_HEADER < captured)
+            return false;
+
+        packet.sec = u32(cursor_);
+        packet.usec = nanosecond_ ? u32(cursor_ + 4) / 1000 : u32(cursor_ + 4);
+        packet.data = data_ + cursor_ + PCAP_RECORD_HEADER;
+        packet.length = captured;
+        packet.link_type = link_type_;
+        cursor_ += PCAP_RECORD_HEADER + captured;
+        return true;
+    }
+
+    bool nextPcapNgPacket(Packet &packet)
+    {
+        while (size_ - cursor_ >= 12)
+        {
+            size_t block = cursor_;
+            uint32_t type;
+            std::memcpy(&type, data_ + block, sizeof(type));
+            if (type == NG_SECTION)
+            {
+                // The section's own byte order applies from its length on.
+                uint32_t order;
+                std::memcpy(&order, data_ + block + 8, sizeof(order));
+                swapped_ = order != NG_BYTE_ORDER;
+                interfaces_.clear();
+            }
+            else
+            {
+                type = u32(block);
+            }
+
+            uint32_t length = u32(block + 4);
+            if (length < 12 || length % 4 != 0 || length > size_ - block)
+                return false;
+            cursor_ += length;
+
+            if (type == NG_INTERFACE && length >= 20)
+                interfaces_.push_back(readInterface(block, length));
+            else if (type == NG_ENHANCED_PACKET && length >= 32 && enhancedPacket(block, length, packet))
+                return true;
+            else if (type == NG_SIMPLE_PACKET && length >= 16 && simplePacket(block, length, packet))
+                return true;
+        }
+        return false;
+    }
+
+    Interface readInterface(size_t block, uint32_t length) const
+    {
+        Interface iface{u16(block + 8), 1'000'000, -1};
+        if (!supported(iface.link_type))
+            iface.link_type = LINK_UNSUPPORTED;
+
+        size_t option = block + 16;
+        size_t end = block + length - 4;
+        while (end - option >= 4)
+        {
+            uint16_t code = u16(option);
+            uint16_t size = u16(option + 2);
+            if (code == 0 || size > end - option - 4)
+                break;
+            if (code == NG_OPT_TSRESOL && size >= 1)
+            {
+                iface.resolution = resolutionUnits(data_[option + 4]);
+                if (iface.resolution == 0)
+                    iface.link_type = LINK_UNSUPPORTED;
+                else if ((iface.resolution & (iface.resolution - 1)) == 0 && iface.resolution <= uint64_t{1} << 44)
+                    iface.shift = __builtin_ctzll(iface.resolution);
+            }
+            option += 4 + ((size + 3u) & ~3u);
+        }
+        return iface;
+    }
+
+    // Units per second for an if_tsresol value (high bit clear: 10^-n
+    // seconds, set: 2^-n seconds); 0 if that does not fit in 64 bits.
+    static uint64_t resolutionUnits(uint8_t resol)
+    {
+        int exponent = resol & 0x7F;
+        if (resol & 0x80)
+            return exponent < 64 ? uint64_t{1} << exponent : 0;
+
+        uint64_t units = 1;
+        for (; exponent > 0; --exponent)
+        {
+            if (units > UINT64_MAX / 10)
+                return 0;
+            units *= 10;
+        }
+        return units;
+    }
+
+    bool enhancedPacket(size_t block, uint32_t length, Packet &packet)
+    {
+        uint32_t id = u32(block + 8);
+        uint32_t captured = u32(block + 20);
+        if (captured > length - 32)
+            return false;
+
+        packet.data = data_ + block + 28;
+        packet.length = captured;
+        if (id >= interfaces_.size())
+        {
+            // Counted, then skipped, like any packet that cannot be used.
+            packet.link_type = LINK_UNSUPPORTED;
+            packet.sec = packet.usec = 0;
+            return true;
+        }
+
+        const Interface &iface = interfaces_[id];
+        uint64_t stamp = uint64_t{u32(block + 12)} << 32 | u32(block + 16);
+        splitTimestamp(stamp, iface, packet);
+        packet.link_type = iface.link_type;
+        return true;
+    }
+
+    bool simplePacket(size_t block, uint32_t length, Packet &packet)
+    {
+        uint32_t original = u32(block + 8);
+        packet.data = data_ + block + 12;
+        packet.length = original < length - 16 ? original : length - 16;
+        packet.link_type = interfaces_.empty() ? LINK_UNSUPPORTED : interfaces_[0].link_type;
+        packet.sec = packet.usec = 0;
+        return true;
+    }
+
+    static void splitTimestamp(uint64_t stamp, const Interface &iface, Packet &packet)
+    {
+        // The common resolutions divide by constants, which compile to
+        // multiplications, and binary ones shift.
+        uint64_t resolution = iface.resolution;
+        if (resolution == 1'000'000)
+        {
+            packet.sec = static_cast<uint32_t>(stamp / 1'000'000);
+            packet.usec = static_cast<uint32_t>(stamp % 1'000'000);
+        }
+        else if (resolution == 1'000'000'000)
+        {
+            packet.sec = static_cast<uint32_t>(stamp / 1'000'000'000);
+            packet.usec = static_cast<uint32_t>(stamp % 1'000'000'000 / 1000);
+        }
+        else if (iface.shift >= 0)
+        {
+            packet.sec = static_cast<uint32_t>(stamp >> iface.shift);
+            packet.usec = static_cast<uint32_t>(((stamp & (resolution - 1)) * 1'000'000) >> iface.shift);
+        }
+        else
+        {
+            packet.sec = static_cast<uint32_t>(stamp / resolution);
+            unsigned __int128 fraction = stamp % resolution;
+            packet.usec = static_cast<uint32_t>(fraction * 1'000'000 / resolution);
+        }
+    }
+
+    // The IPv4 header inside a captured frame, or nullptr if the frame does
+    // not carry a complete one.
+    static const unsigned char *ipv4Header(const Packet &packet)
+    {
+        const unsigned char *frame = packet.data;
+        size_t offset;
+        switch (packet.link_type)
+        {
+        case LINK_ETHERNET:
+        {
+            if (packet.length < 14)
+                return nullptr;
+            uint16_t ethertype = be16(frame + 12);
+            offset = 14;
+            while (ethertype == 0x8100 || ethertype == 0x88A8 || ethertype == 0x9100)
+            {
+                if (packet.length < offset + 4)
+                    return nullptr;
+                ethertype = be16(frame + offset + 2);
+                offset += 4;
+            }
+            if (ethertype != 0x0800)
+                return nullptr;
+            break;
+        }
+        case LINK_LINUX_SLL:
+            if (packet.length < 16 || be16(frame + 14) != 0x0800)
+                return nullptr;
+            offset = 16;
+            break;
+        case LINK_RAW:
+        case LINK_IPV4:
+            offset = 0;
+            break;
+        default:
+            return nullptr;
+        }
+
+        if (packet.length < offset + IPV4_HEADER || (frame[offset] >> 4) != 4)
+            return nullptr;
+        return frame + offset;
+    }
+
+    static uint16_t be16(const unsigned char *p)
+    {
+        return static_cast<uint16_t>(p[0] << 8 | p[1]);
+    }
+};
+
+#endif
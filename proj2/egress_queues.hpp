@@ -0,0 +1,493 @@
+#ifndef EGRESS_QUEUES_HPP
+#define EGRESS_QUEUES_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "timer_wheel.hpp"
+
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: egress_queues.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  This code simulates what happens to packets after proj2 -s has picked an
+ *  interface: every configured interface has a FIFO output queue drained by
+ *  a token-bucket shaper, with tail drop or RED when the queue fills.
+ *  Packets arrive at their trace timestamps; departures are events on a
+ *  TimerWheel (timer_wheel.hpp).
+ *
+ * =============================================================================
+ *  Queue file format (one directive per line, '#' starts a comment):
+ *
+ *      queue <iface|default> <rate> <burst> <buffer> [tail | red <min> <max> <max_p>]
+ *
+ *    - rate is in bits per second with an optional k, M or G suffix.
+ *    - burst (token bucket depth), buffer (queue limit), min and max (RED
+ *      thresholds) are in bytes; max_p is the RED drop probability at max.
+ *    - "default" applies to every interface without its own line. Without
+ *      it, other interfaces are not shaped and their packets are not
+ *      simulated.
+ *
+ *    Example:
+ *      queue default 1G 15000 256000
+ *      queue 3 10M 3000 64000 red 16000 48000 0.1
+ *
+ *  ---------------------------------------------------------------------------
+ *  Class: EgressSimulator
+ *  ---------------------------------------------------------------------------
+ *  - arrive(): advances the wheel to the packet's time, firing earlier
+ *    departures, then admits or drops the packet. A packet is sent at once
+ *    if its queue is empty and the bucket holds enough tokens; otherwise it
+ *    waits, and the queue's head has one departure event on the wheel, at
+ *    the time the bucket will have refilled enough for it. A packet larger
+ *    than the bucket waits for a full bucket and leaves it in deficit.
+ *  - Tail drop: a packet is dropped if it does not fit in buffer bytes.
+ *    RED additionally keeps an exponentially weighted average of the
+ *    backlog (weight RED_WEIGHT, updated per arrival) and drops with a
+ *    probability rising linearly from 0 at min to max_p at max, and always
+ *    above max.
+ *  - Times are integer microseconds. Arrivals earlier than the simulated
+ *    clock (a trace that is not sorted by time) are counted and treated as
+ *    arriving now.
+ *  - Queueing delay (departure - arrival) goes into a log-linear histogram
+ *    with 32 sub-buckets per power of two, so percentiles are within about
+ *    3% and memory does not grow with the number of packets.
+ * =============================================================================
+ */
+
+struct QueueConfig
+{
+    double rate_bps = 0;
+    uint32_t burst = 0;
+    uint32_t buffer = 0;
+    bool red = false;
+    uint32_t red_min = 0;
+    uint32_t red_max = 0;
+    double red_max_p = 0;
+};
+
+class QueueConfigTable
+{
+public:
+    explicit QueueConfigTable(const std::string &filename)
+        : configured_(65536, false), configs_(65536)
+    {
+        loadFromFile(filename);
+    }
+
+    // Null if the interface is not shaped.
+    const QueueConfig *find(uint16_t iface) const
+    {
+        if (configured_[iface])
+            return &configs_[iface];
+        return has_default_ ? &default_ : nullptr;
+    }
+
+private:
+    std::vector<bool> configured_;
+    std::vector<QueueConfig> configs_;
+    QueueConfig default_;
+    bool has_default_ = false;
+
+    void loadFromFile(const std::string &filename)
+    {
+        std::ifstream file(filename);
+        if (!file.is_open())
+            throw std::runtime_error("Error: cannot open queue file '" + filename + "'");
+
+        std::string line;
+        int line_no = 0;
+        while (std::getline(file, line))
+        {
+            ++line_no;
+            std::istringstream in(line.substr(0, line.find('#')));
+            std::string directive;
+            if (!(in >> directive))
+                continue;
+            if (directive != "queue")
+                throw parseError(line_no, "unknown directive '" + directive + "'");
+            parseQueue(in, line_no);
+        }
+    }
+
+    void parseQueue(std::istringstream &in, int line_no)
+    {
+        std::string target, rate, burst, buffer, discipline;
+        if (!(in >> target >> rate >> burst >> buffer))
+            throw parseError(line_no, "expected 'queue <iface|default> <rate> <burst> <buffer>'");
+
+        QueueConfig config;
+        if (!parseRate(rate, config.rate_bps))
+            throw parseError(line_no, "bad rate '" + rate + "'");
+        if (!parseBytes(burst, config.burst) || config.burst == 0)
+            throw parseError(line_no, "bad burst '" + burst + "'");
+        if (!parseBytes(buffer, config.buffer))
+            throw parseError(line_no, "bad buffer '" + buffer + "'");
+
+        if (in >> discipline)
+        {
+            std::string min, max, max_p, extra;
+            if (discipline == "red")
+            {
+                if (!(in >> min >> max >> max_p) || !parseBytes(min, config.red_min) ||
+                    !parseBytes(max, config.red_max) || config.red_min >= config.red_max ||
+                    !parseProbability(max_p, config.red_max_p))
+                    throw parseError(line_no, "expected 'red <min> <max> <max_p>' with min < max");
+                config.red = true;
+            }
+            else if (discipline != "tail")
+            {
+                throw parseError(line_no, "unknown discipline '" + discipline + "'");
+            }
+            if (in >> extra)
+                throw parseError(line_no, "unexpected '" + extra + "'");
+        }
+
+        if (target == "default")
+        {
+            if (has_default_)
+                throw parseError(line_no, "duplicate default queue");
+            default_ = config;
+            has_default_ = true;
+            return;
+        }
+
+        int iface = 0;
+        if (!parseInterface(target, iface))
+            throw parseError(line_no, "bad interface '" + target + "'");
+        if (configured_[iface])
+            throw parseError(line_no, "duplicate queue for interface " + target);
+        configured_[iface] = true;
+        configs_[iface] = config;
+    }
+
+    static bool isDigits(const std::string &text)
+    {
+        return !text.empty() && text.size() <= 10 &&
+               std::all_of(text.begin(), text.end(), [](char c)
+                           { return c >= '0' && c <= '9'; });
+    }
+
+    static bool parseInterface(const std::string &text, int &iface)
+    {
+        if (!isDigits(text) || text.size() > 5)
+            return false;
+        iface = std::stoi(text);
+        return iface <= 65535;
+    }
+
+    static bool parseBytes(const std::string &text, uint32_t &bytes)
+    {
+        if (!isDigits(text))
+            return false;
+        unsigned long long value = std::stoull(text);
+        bytes = static_cast<uint32_t>(value);
+        return value <= 0xFFFFFFFFULL;
+    }
+
+    static bool parseRate(const std::string &text, double &bps)
+    {
+        std::string digits = text;
+        double scale = 1;
+        switch (text.empty() ? '\0' : text.back())
+        {
+        case 'k':
+            scale = 1e3;
+            break;
+        case 'M':
+            scale = 1e6;
+            break;
+        case 'G':
+            scale = 1e9;
+            break;
+        default:
+            break;
+        }
+        if (scale != 1)
+            digits.pop_back();
+        if (!isDigits(digits))
+            return false;
+        bps = static_cast<double>(std::stoull(digits)) * scale;
+        return bps > 0;
+    }
+
+    static bool parseProbability(const std::string &text, double &p)
+    {
+        std::istringstream in(text);
+        char extra;
+        return (in >> p) && !(in >> extra) && p > 0 && p <= 1;
+    }
+
+    static std::runtime_error parseError(int line_no, const std::string &what)
+    {
+        return std::runtime_error("Error: invalid queue file line " + std::to_string(line_no) + " (" + what + ")");
+    }
+};
+
+class DelayHistogram
+{
+public:
+    void add(uint64_t usec)
+    {
+        ++buckets_[bucketOf(usec)];
+        ++count_;
+        max_ = std::max(max_, usec);
+    }
+
+    uint64_t count() const noexcept { return count_; }
+    uint64_t max() const noexcept { return max_; }
+
+    // Upper edge of the bucket holding the p-quantile (capped at the max).
+    uint64_t percentile(double p) const
+    {
+        if (count_ == 0)
+            return 0;
+        uint64_t rank = static_cast<uint64_t>(p * static_cast<double>(count_ - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t b = 0; b < BUCKETS; ++b)
+        {
+            seen += buckets_[b];
+            if (seen >= rank)
+                return std::min(upperEdge(b), max_);
+        }
+        return max_;
+    }
+
+private:
+    static constexpr int SUB_BITS = 5;
+    static constexpr uint64_t LINEAR = uint64_t{1} << (SUB_BITS + 1);
+    static constexpr size_t BUCKETS = LINEAR + (64 - SUB_BITS - 1) * (size_t{1} << SUB_BITS);
+
+    uint64_t buckets_[BUCKETS] = {};
+    uint64_t count_ = 0;
+    uint64_t max_ = 0;
+
+    // Exact below LINEAR, then 2^SUB_BITS buckets per power of two.
+    static size_t bucketOf(uint64_t v) noexcept
+    {
+        if (v < LINEAR)
+            return static_cast<size_t>(v);
+        int exponent = 63 - __builtin_clzll(v);
+        uint64_t sub = (v >> (exponent - SUB_BITS)) & ((uint64_t{1} << SUB_BITS) - 1);
+        return static_cast<size_t>(LINEAR + (exponent - SUB_BITS - 1) * (uint64_t{1} << SUB_BITS) + sub);
+    }
+
+    static uint64_t upperEdge(size_t bucket) noexcept
+    {
+        if (bucket < LINEAR)
+            return bucket;
+        uint64_t index = bucket - LINEAR;
+        int exponent = static_cast<int>(index >> SUB_BITS) + SUB_BITS + 1;
+        uint64_t sub = index & ((uint64_t{1} << SUB_BITS) - 1);
+        uint64_t width = uint64_t{1} << (exponent - SUB_BITS);
+        return (uint64_t{1} << exponent) + (sub + 1) * width - 1;
+    }
+};
+
+class EgressSimulator
+{
+public:
+    static constexpr double RED_WEIGHT = 0.002;
+
+    struct InterfaceStats
+    {
+        uint16_t iface;
+        double rate_bps;
+        uint64_t arrivals;
+        uint64_t sent;
+        uint64_t tail_drops;
+        uint64_t red_drops;
+        uint32_t max_backlog;
+        const DelayHistogram *delays;
+    };
+
+    explicit EgressSimulator(const QueueConfigTable &configs)
+        : configs_(configs), queue_index_(65536, -1) {}
+
+    void arrive(uint16_t iface, uint64_t usec, uint32_t bytes)
+    {
+        int index = queueIndex(iface);
+        if (index < 0)
+            return;
+
+        if (usec < wheel_.now())
+        {
+            ++late_arrivals_;
+            usec = wheel_.now();
+        }
+        wheel_.advance(usec, [this](uint32_t id, uint64_t now)
+                       { depart(queues_[id], id, now); });
+
+        Queue &q = queues_[index];
+        ++q.arrivals;
+        refill(q, usec);
+
+        if (q.config.red && !admitRed(q))
+        {
+            ++q.red_drops;
+            return;
+        }
+        if (static_cast<uint64_t>(q.backlog) + bytes > q.config.buffer)
+        {
+            ++q.tail_drops;
+            return;
+        }
+
+        if (q.head == q.packets.size() && q.tokens >= needed(q, bytes))
+        {
+            q.tokens -= bytes;
+            ++q.sent;
+            q.delays.add(0);
+            return;
+        }
+
+        q.packets.push_back({usec, bytes});
+        q.backlog += bytes;
+        q.max_backlog = std::max(q.max_backlog, q.backlog);
+        if (q.packets.size() - q.head == 1)
+            scheduleHead(q, static_cast<uint32_t>(index));
+    }
+
+    // Sends everything still queued.
+    void finish()
+    {
+        wheel_.drain([this](uint32_t id, uint64_t now)
+                     { depart(queues_[id], id, now); });
+    }
+
+    uint64_t lateArrivals() const noexcept { return late_arrivals_; }
+
+    // Interfaces that saw traffic, by interface number.
+    std::vector<InterfaceStats> statistics() const
+    {
+        std::vector<InterfaceStats> stats;
+        for (const Queue &q : queues_)
+            stats.push_back({q.iface, q.config.rate_bps, q.arrivals, q.sent, q.tail_drops, q.red_drops,
+                             q.max_backlog, &q.delays});
+        std::sort(stats.begin(), stats.end(), [](const InterfaceStats &a, const InterfaceStats &b)
+                  { return a.iface < b.iface; });
+        return stats;
+    }
+
+private:
+    struct Packet
+    {
+        uint64_t arrival;
+        uint32_t bytes;
+    };
+
+    struct Queue
+    {
+        uint16_t iface;
+        QueueConfig config;
+        double bytes_per_usec;
+        double tokens;
+        uint64_t refilled_at;
+        double red_average = 0;
+        uint64_t red_state;
+        // FIFO as a vector with a moving head, compacted when half empty.
+        std::vector<Packet> packets;
+        size_t head = 0;
+        uint32_t backlog = 0;
+        uint32_t max_backlog = 0;
+        uint64_t arrivals = 0;
+        uint64_t sent = 0;
+        uint64_t tail_drops = 0;
+        uint64_t red_drops = 0;
+        DelayHistogram delays;
+    };
+
+    const QueueConfigTable &configs_;
+    std::vector<int> queue_index_;
+    std::vector<Queue> queues_;
+    TimerWheel wheel_;
+    uint64_t late_arrivals_ = 0;
+
+    int queueIndex(uint16_t iface)
+    {
+        if (queue_index_[iface] >= 0 || queue_index_[iface] == -2)
+            return queue_index_[iface] >= 0 ? queue_index_[iface] : -1;
+
+        const QueueConfig *config = configs_.find(iface);
+        if (!config)
+        {
+            queue_index_[iface] = -2;
+            return -1;
+        }
+        Queue q;
+        q.iface = iface;
+        q.config = *config;
+        q.bytes_per_usec = config->rate_bps / 8e6;
+        q.tokens = config->burst;
+        q.refilled_at = wheel_.now();
+        q.red_state = 0x9E3779B97F4A7C15ULL * (iface + 1ULL);
+        queues_.push_back(std::move(q));
+        queue_index_[iface] = static_cast<int>(queues_.size() - 1);
+        return queue_index_[iface];
+    }
+
+    // Tokens a packet waits for before it may leave.
+    static double needed(const Queue &q, uint32_t bytes)
+    {
+        return std::min<double>(bytes, q.config.burst);
+    }
+
+    static void refill(Queue &q, uint64_t now)
+    {
+        q.tokens = std::min<double>(q.config.burst, q.tokens + static_cast<double>(now - q.refilled_at) * q.bytes_per_usec);
+        q.refilled_at = now;
+    }
+
+    static bool admitRed(Queue &q)
+    {
+        q.red_average += RED_WEIGHT * (static_cast<double>(q.backlog) - q.red_average);
+        if (q.red_average < q.config.red_min)
+            return true;
+        if (q.red_average >= q.config.red_max)
+            return false;
+
+        double p = q.config.red_max_p * (q.red_average - q.config.red_min) / (q.config.red_max - q.config.red_min);
+        // xorshift64: a fixed per-queue stream keeps runs reproducible.
+        q.red_state ^= q.red_state << 13;
+        q.red_state ^= q.red_state >> 7;
+        q.red_state ^= q.red_state << 17;
+        return static_cast<double>(q.red_state >> 11) * 0x1.0p-53 >= p;
+    }
+
+    void scheduleHead(Queue &q, uint32_t index)
+    {
+        double missing = needed(q, q.packets[q.head].bytes) - q.tokens;
+        uint64_t wait = missing <= 0 ? 0 : static_cast<uint64_t>(missing / q.bytes_per_usec) + 1;
+        wheel_.schedule(index, q.refilled_at + wait);
+    }
+
+    void depart(Queue &q, uint32_t index, uint64_t now)
+    {
+        refill(q, now);
+        while (q.head < q.packets.size() && q.tokens >= needed(q, q.packets[q.head].bytes))
+        {
+            const Packet &p = q.packets[q.head++];
+            q.tokens -= p.bytes;
+            q.backlog -= p.bytes;
+            ++q.sent;
+            q.delays.add(now - p.arrival);
+        }
+
+        if (q.head * 2 >= q.packets.size())
+        {
+            q.packets.erase(q.packets.begin(), q.packets.begin() + static_cast<std::ptrdiff_t>(q.head));
+            q.head = 0;
+        }
+        if (q.head < q.packets.size())
+            scheduleHead(q, index);
+    }
+};
+
+#endif
@@ -0,0 +1,166 @@
+#ifndef FLAT_PREFIX_TABLE_HPP
+#define FLAT_PREFIX_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "huge_pages.hpp"
+
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: flat_prefix_table.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  This class is an open-addressing hash table from a masked IPv4 prefix to
+ *  a small value, used by ForwardingTable for each supported prefix length.
+ *
+ * =============================================================================
+ *  Class: FlatPrefixTable<Value>
+ *  ---------------------------------------------------------------------------
+ *  Layout:
+ *    One contiguous array of slots; each slot holds the key, the value and
+ *    the slot's distance from its home bucket plus one (0 marks an empty
+ *    slot). For Value = uint16_t a slot is 8 bytes, so eight slots share a
+ *    cache line and a lookup usually touches exactly one line.
+ *
+ *  Robin Hood hashing:
+ *    - insert: walk from the home bucket; whenever the resident element is
+ *      closer to its own home than the element being placed, swap them and
+ *      keep placing the evicted one. Probe distances stay short and even.
+ *    - find: walk from the home bucket and stop at an empty slot or as soon
+ *      as the resident's distance is smaller than ours; the key cannot be
+ *      further along.
+ *    - The table doubles when it would become more than 3/4 full, or when
+ *      an insert probes MAX_DISTANCE slots (heavily clustered input).
+ *      Probe distances are therefore bounded and fit the 16-bit slot field.
+ *
+ *  Hashing:
+ *    Fibonacci hashing (multiply by 2^64 / phi, keep the top bits). Prefix
+ *    keys have all their entropy in the high bits and zero low bits, which
+ *    a multiplicative hash spreads well without a separate mixing step.
+ *
+ *  The slot array comes from HugePageAllocator, so large tables are backed
+ *  by huge pages when that is enabled (huge_pages.hpp).
+ * =============================================================================
+ */
+template <typename Value>
+class FlatPrefixTable
+{
+public:
+    FlatPrefixTable() { resize(MIN_CAPACITY); }
+
+    const Value *find(uint32_t key) const noexcept
+    {
+        size_t i = home(key);
+        for (uint16_t dist = 1;; ++dist, i = (i + 1) & mask_)
+        {
+            const Slot &slot = slots_[i];
+            if (slot.dist < dist)
+                return nullptr;
+            if (slot.key == key)
+                return &slot.value;
+        }
+    }
+
+    bool contains(uint32_t key) const noexcept { return find(key) != nullptr; }
+
+    void insertOrAssign(uint32_t key, Value value)
+    {
+        if (Value *existing = const_cast<Value *>(find(key)))
+        {
+            *existing = value;
+            return;
+        }
+        if ((size_ + 1) * 4 > slots_.size() * 3)
+            resize(slots_.size() * 2);
+        place({key, value, 1});
+        ++size_;
+    }
+
+    // Sizes the table for n entries up front, so inserting them never
+    // rehashes.
+    void reserve(size_t n)
+    {
+        size_t capacity = slots_.size();
+        while (n * 4 > capacity * 3)
+            capacity *= 2;
+        if (capacity != slots_.size())
+            resize(capacity);
+    }
+
+    // Visits entries in slot order, i.e. roughly sorted by hash. Inserting
+    // them in this order into another table clusters badly; sort them first.
+    template <typename Fn>
+    void forEach(Fn fn) const
+    {
+        for (const Slot &slot : slots_)
+            if (slot.dist != 0)
+                fn(slot.key, slot.value);
+    }
+
+    size_t size() const noexcept { return size_; }
+    size_t capacity() const noexcept { return slots_.size(); }
+    size_t memoryBytes() const noexcept { return slots_.size() * sizeof(Slot); }
+
+private:
+    static constexpr size_t MIN_CAPACITY = 16;
+    static constexpr uint16_t MAX_DISTANCE = 256;
+
+    struct Slot
+    {
+        uint32_t key;
+        Value value;
+        uint16_t dist;
+    };
+
+    using SlotArray = std::vector<Slot, HugePageAllocator<Slot>>;
+
+    SlotArray slots_;
+    size_t mask_ = 0;
+    int shift_ = 0;
+    size_t size_ = 0;
+
+    size_t home(uint32_t key) const noexcept
+    {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> shift_);
+    }
+
+    void place(Slot incoming)
+    {
+        size_t i = home(incoming.key);
+        while (true)
+        {
+            Slot &slot = slots_[i];
+            if (slot.dist == 0)
+            {
+                slot = incoming;
+                return;
+            }
+            if (slot.dist < incoming.dist)
+                std::swap(slot, incoming);
+            if (++incoming.dist > MAX_DISTANCE)
+            {
+                resize(slots_.size() * 2);
+                incoming.dist = 1;
+                i = home(incoming.key);
+                continue;
+            }
+            i = (i + 1) & mask_;
+        }
+    }
+
+    void resize(size_t capacity)
+    {
+        SlotArray old(capacity, Slot{0, Value{}, 0});
+        old.swap(slots_);
+        mask_ = capacity - 1;
+        shift_ = 64 - __builtin_ctzll(capacity);
+        for (const Slot &slot : old)
+            if (slot.dist != 0)
+                place({slot.key, slot.value, 1});
+    }
+};
+
+#endif
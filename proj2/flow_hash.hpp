@@ -0,0 +1,101 @@
+#ifndef FLOW_HASH_HPP
+#define FLOW_HASH_HPP
+
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <nmmintrin.h>
+#endif
+
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: flow_hash.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  CRC32C (Castagnoli) hash of a packet's five-tuple, used to pin flows to
+ *  one member of a next-hop group. On x86 CPUs with SSE4.2 the hardware
+ *  crc32 instruction is used; elsewhere a table-driven software CRC gives
+ *  bit-identical results, so path selection does not depend on the host.
+ */
+
+class FlowHash
+{
+public:
+    // All fields in host byte order.
+    static uint32_t hash(uint32_t src, uint32_t dst, uint8_t proto, uint16_t sport, uint16_t dport)
+    {
+        static const bool hardware = hasHardwareCrc();
+#if defined(__x86_64__) || defined(__i386__)
+        if (hardware)
+            return hashHardware(src, dst, proto, sport, dport);
+#endif
+        return hashSoftware(src, dst, proto, sport, dport);
+    }
+
+    static bool hasHardwareCrc()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __builtin_cpu_supports("sse4.2");
+#else
+        return false;
+#endif
+    }
+
+    static uint32_t hashSoftware(uint32_t src, uint32_t dst, uint8_t proto, uint16_t sport, uint16_t dport)
+    {
+        uint32_t crc = SEED;
+        crc = crc32cWord(crc, src);
+        crc = crc32cWord(crc, dst);
+        crc = crc32cWord(crc, (static_cast<uint32_t>(sport) << 16) | dport);
+        crc = crc32cByte(crc, proto);
+        return ~crc;
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    __attribute__((target("sse4.2"))) static uint32_t hashHardware(uint32_t src, uint32_t dst, uint8_t proto,
+                                                                   uint16_t sport, uint16_t dport)
+    {
+        uint32_t crc = SEED;
+        crc = _mm_crc32_u32(crc, src);
+        crc = _mm_crc32_u32(crc, dst);
+        crc = _mm_crc32_u32(crc, (static_cast<uint32_t>(sport) << 16) | dport);
+        crc = _mm_crc32_u8(crc, proto);
+        return ~crc;
+    }
+#endif
+
+private:
+    static constexpr uint32_t SEED = 0xFFFFFFFF;
+    static constexpr uint32_t POLY = 0x82F63B78; // reflected Castagnoli polynomial
+
+    struct Table
+    {
+        uint32_t v[256];
+        constexpr Table() : v()
+        {
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k)
+                    c = (c & 1) ? (c >> 1) ^ POLY : c >> 1;
+                v[i] = c;
+            }
+        }
+    };
+
+    static uint32_t crc32cByte(uint32_t crc, uint8_t byte)
+    {
+        static constexpr Table TABLE{};
+        return (crc >> 8) ^ TABLE.v[(crc ^ byte) & 0xFF];
+    }
+
+    // Matches _mm_crc32_u32: the word is consumed least significant byte first.
+    static uint32_t crc32cWord(uint32_t crc, uint32_t word)
+    {
+        for (int i = 0; i < 4; ++i)
+            crc = crc32cByte(crc, static_cast<uint8_t>(word >> (8 * i)));
+        return crc;
+    }
+};
+
+#endif
@@ -2,14 +2,23 @@
 #define FORWARDING_TABLE_HPP
 
 #include <iostream>
-#include <fstream>
 #include <vector>
-#include <unordered_map>
-#include <set>
+#include <array>
+#include <algorithm>
+#include <thread>
+#include <utility>
 #include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <cstdint>
+#include <cstring>
 #include <stdexcept>
 #include <string>
+#include "flat_prefix_table.hpp"
+#include "prefix_bloom_filter.hpp"
+#include "length_search_index.hpp"
 
 /**
  * Name: Shankar Choudhury
@@ -39,8 +48,10 @@
  *        - iface:      Interface number for outgoing packets
  *
  *  - tables_:
- *      A map of prefix-lengths → prefix-to-entry hash tables.
- *      Each table provides O(1) lookup for IPs of the same prefix length.
+ *      A fixed array of four open-addressing hash tables (FlatPrefixTable),
+ *      one per prefix length, indexed by prefix_len / 8 - 1. Each maps a
+ *      masked prefix to its interface only, so a lookup is a handful of
+ *      probes into one flat array per length.
  *      Only the prefix lengths {8, 16, 24, 32} are supported
  *
  *  - all_entries_:
@@ -51,17 +62,36 @@
  *      Stores the interface ID for the default route (0.0.0.0/8).
  *      Used when no explicit prefix matches a destination.
  *
+ *  - engine_ / blooms_ / length_search_:
+ *      The lookup engine chosen at construction. LookupEngine::Bloom adds
+ *      one PrefixBloomFilter per prefix length; LookupEngine::LengthSearch
+ *      adds a LengthSearchIndex. Both are built once loading is done.
+ *
+ *  - specialized_:
+ *      With LookupEngine::Specialized, the matcher instantiated for exactly
+ *      the prefix lengths present in the loaded table (see below).
+ *
  *  ---------------------------------------------------------------------------
  *  File Loading Process (loadFromFile):
- *  1. Opens the binary forwarding table file and reads fixed-size Entry structs.
- *  2. Validates each entry for:
- *        - Correct prefix length (must be 8, 16, 24, or 32)
- *        - Absence of duplicate (prefix, prefix_len) pairs
- *  3. Converts all network byte order values to host order.
- *  4. Detects and stores the default route (addr = 0).
- *  5. Organizes entries into per-prefix tables for O(1) lookup.
+ *  1. Maps the binary forwarding table file with mmap() (a non-regular file
+ *     is read into memory instead).
+ *  2. Converts the fixed-size entries from network to host byte order in
+ *     parallel chunks, one per hardware thread, and notes the first entry
+ *     whose prefix length is not 8, 16, 24 or 32.
+ *  3. Builds the four per-prefix tables in parallel, one thread per length,
+ *     each inserting its entries in file order. The table being built also
+ *     detects duplicate (prefix, prefix_len) pairs, so no separate set of
+ *     seen pairs is needed.
+ *  4. Reports whichever invalid or duplicate entry comes first in the file,
+ *     with the same message a one-entry-at-a-time load would have given.
+ *  5. Detects and stores the default route (addr = 0).
  *  6. Validates that the final table is not empty.
  *
+ *  The second constructor runs the same steps (2-6) over entries that are
+ *  already in host byte order, e.g. synthetic tables built by the lookup
+ *  benchmark. Tables under PARALLEL_MIN entries are loaded on the calling
+ *  thread alone.
+ *
  *  ---------------------------------------------------------------------------
  *  Lookup Process (lookup):
  *  Given a destination IP address (in host byte order):
@@ -75,28 +105,51 @@
  *       returns the default interface.
  *    5. Returns -1 if no route exists.
  *
+ *  With LookupEngine::Bloom, step 2 first tests all four Bloom filters
+ *  without branching and collects the lengths that may match in a bitmask.
+ *  Only those tables are probed, longest first; a filter false positive
+ *  just costs one wasted probe, so results are identical to the hash
+ *  engine. Most destinations match one length, so a lookup usually does
+ *  a single table probe instead of up to four.
+ *
+ *  With LookupEngine::LengthSearch, steps 1-3 are replaced by a binary
+ *  search over the prefix lengths present (see length_search_index.hpp):
+ *  at most 3 probes for the four supported lengths, and the same code
+ *  would need at most 6 for arbitrary lengths.
+ *
+ *  With LookupEngine::Specialized, steps 1-3 run in matchLengths<Lens...>,
+ *  a template over a descending pack of prefix lengths. The probe sequence
+ *  is a fold expression, so every mask and table index is a constant and
+ *  the loop disappears. specializedFor() has one instantiation for each of
+ *  the 16 subsets of {8, 16, 24, 32}; after loading, the subset of lengths
+ *  actually present picks one, so e.g. a table with only /24 and /32
+ *  entries does exactly two probes on a miss.
+ *
  *  ---------------------------------------------------------------------------
  *  Supporting Static Utilities:
  *    - prefixMask(int prefix_len):
  *        Returns a 32-bit mask corresponding to the given prefix length.
  *    - ipToString(uint32_t ip):
  *        Converts an IPv4 integer into dotted-decimal format.
- *    - readEntry():
- *        Reads an Entry struct from the file, converting from network byte order.
- *    - validateEntry():
- *        Ensures the prefix length is supported (8, 16, 24, 32).
- *    - checkDuplicate():
- *        Detects duplicate entries and throws an exception if found.
+ *    - MappedFile:
+ *        The whole forwarding file, mapped or read, unmapped on destruction.
+ *    - firstInChunks() / runTasks():
+ *        Run a scan over parallel chunks, or one task per thread.
+ *    - buildTables() / buildTable():
+ *        Fill the per-length tables and find the first duplicate entry.
+ *        A prefix with a non-zero masked address can only be stored under
+ *        its own length, so the per-length tables themselves answer whether
+ *        it was seen. Address-0 entries are all stored as 0.0.0.0/8, so
+ *        each length keeps a flag for masked prefix 0 instead.
  *    - handleDefaultEntry():
  *        Identifies and records the default route entry (0.0.0.0/8).
- *    - storeEntry():
- *        Inserts entries into both the prefix table and master list.
  *
  *  ---------------------------------------------------------------------------
  *  Design Notes:
  *  - Only four prefix lengths are supported (8, 16, 24, and 32)
  *  - Lookup uses deterministic longest-prefix ordering.
- *  - Uses unordered_map for O(1) lookups and std::set for duplicate detection.
+ *  - Uses flat open-addressing tables for O(1) lookups and duplicate
+ *    detection.
  *
  *  ---------------------------------------------------------------------------
  *  Example Usage:
@@ -120,22 +173,51 @@ public:
         uint16_t iface;
     };
 
-    explicit ForwardingTable(const std::string &filename)
+    enum class LookupEngine
+    {
+        Hash,
+        Bloom,
+        LengthSearch,
+        Specialized
+    };
+
+    explicit ForwardingTable(const std::string &filename, LookupEngine engine = LookupEngine::Hash)
+        : engine_(engine)
     {
         loadFromFile(filename);
+        buildEngine();
+    }
+
+    explicit ForwardingTable(const std::vector<Entry> &entries, LookupEngine engine = LookupEngine::Hash)
+        : engine_(engine)
+    {
+        loadFromEntries(entries);
+        buildEngine();
     }
 
     int lookup(uint32_t dest_ip, bool &is_default) const
     {
-        for (int plen : PREFIX_LENGTHS)
+        int iface;
+        switch (engine_)
         {
-            uint32_t masked = dest_ip & prefixMask(plen);
-            auto it = tables_.at(plen).find(masked);
-            if (it != tables_.at(plen).end())
-            {
-                is_default = false;
-                return it->second.iface;
-            }
+        case LookupEngine::Bloom:
+            iface = matchBloom(dest_ip);
+            break;
+        case LookupEngine::LengthSearch:
+            iface = length_search_.match(dest_ip);
+            break;
+        case LookupEngine::Specialized:
+            iface = (this->*specialized_)(dest_ip);
+            break;
+        default:
+            iface = matchHash(dest_ip);
+            break;
+        }
+
+        if (iface >= 0)
+        {
+            is_default = false;
+            return iface;
         }
 
         if (default_iface_ >= 0)
@@ -151,89 +233,339 @@ public:
     bool hasDefault() const noexcept { return default_iface_ >= 0; }
     int getDefault() const noexcept { return default_iface_; }
     const std::vector<Entry> &entries() const noexcept { return all_entries_; }
+    LookupEngine engine() const noexcept { return engine_; }
+
+    // Only meaningful with LookupEngine::Bloom; prefix_len is 8, 16, 24 or 32.
+    const PrefixBloomFilter &bloomFilter(int prefix_len) const { return blooms_[tableIndex(prefix_len)]; }
+
+    // Only meaningful with LookupEngine::LengthSearch.
+    const LengthSearchIndex &lengthSearchIndex() const noexcept { return length_search_; }
 
 private:
     inline static constexpr int PREFIX_LENGTHS[4] = {32, 24, 16, 8};
+    // Smaller tables are loaded on the calling thread alone.
+    static constexpr size_t PARALLEL_MIN = 1 << 16;
 
+    LookupEngine engine_;
     std::vector<Entry> all_entries_;
-    std::unordered_map<int, std::unordered_map<uint32_t, Entry>> tables_;
+    std::array<FlatPrefixTable<uint16_t>, 4> tables_;
+    std::array<PrefixBloomFilter, 4> blooms_;
+    LengthSearchIndex length_search_;
+
+    using MatchFn = int (ForwardingTable::*)(uint32_t) const;
+    MatchFn specialized_ = &ForwardingTable::matchHash;
     int default_iface_ = -1;
 
     void loadFromFile(const std::string &filename)
     {
-        std::ifstream file = openFile(filename);
-        initializeTables();
+        MappedFile file(filename);
+        size_t count = file.size() / sizeof(Entry);
+        all_entries_.resize(count);
 
-        std::set<std::pair<uint32_t, uint16_t>> seen_prefixes;
+        // A trailing partial entry is ignored, as a short read always was.
+        const unsigned char *data = file.data();
+        size_t first_invalid = firstInChunks(count, [&](size_t begin, size_t end)
+                                             {
+            size_t invalid = count;
+            for (size_t i = begin; i < end; ++i)
+            {
+                Entry entry;
+                std::memcpy(&entry, data + i * sizeof(Entry), sizeof(Entry));
+                entry.addr = ntohl(entry.addr);
+                entry.prefix_len = ntohs(entry.prefix_len);
+                entry.iface = ntohs(entry.iface);
+                all_entries_[i] = entry;
+                if (invalid == count && !validLength(entry.prefix_len))
+                    invalid = i;
+            }
+            return invalid; });
 
-        while (true)
-        {
-            Entry entry;
-            if (!readEntry(file, entry))
-                break;
+        buildTables(first_invalid);
+    }
 
-            validateEntry(entry);
+    void loadFromEntries(const std::vector<Entry> &entries)
+    {
+        all_entries_ = entries;
+        size_t count = all_entries_.size();
+        size_t first_invalid = firstInChunks(count, [&](size_t begin, size_t end)
+                                             {
+            for (size_t i = begin; i < end; ++i)
+                if (!validLength(all_entries_[i].prefix_len))
+                    return i;
+            return count; });
 
-            uint32_t masked = entry.addr & prefixMask(entry.prefix_len);
-            checkDuplicate(entry, masked, seen_prefixes);
-            handleDefaultEntry(entry);
+        buildTables(first_invalid);
+    }
 
-            storeEntry(entry, masked);
+    int matchHash(uint32_t dest_ip) const
+    {
+        for (int plen : PREFIX_LENGTHS)
+        {
+            const uint16_t *iface = tables_[tableIndex(plen)].find(dest_ip & prefixMask(plen));
+            if (iface)
+                return *iface;
         }
+        return -1;
+    }
 
-        validateFinalTable();
+    int matchBloom(uint32_t dest_ip) const
+    {
+        // Bit i is set when the filter of PREFIX_LENGTHS[i] may hold the prefix.
+        unsigned candidates = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            int plen = PREFIX_LENGTHS[i];
+            candidates |= static_cast<unsigned>(blooms_[tableIndex(plen)].mayContain(dest_ip & prefixMask(plen))) << i;
+        }
+
+        while (candidates)
+        {
+            int plen = PREFIX_LENGTHS[__builtin_ctz(candidates)];
+            candidates &= candidates - 1;
+            const uint16_t *iface = tables_[tableIndex(plen)].find(dest_ip & prefixMask(plen));
+            if (iface)
+                return *iface;
+        }
+        return -1;
     }
 
-    static std::ifstream openFile(const std::string &filename)
+    template <int... Lens>
+    int matchLengths([[maybe_unused]] uint32_t dest_ip) const
     {
-        std::ifstream file(filename, std::ios::binary);
-        if (!file.is_open())
-            throw std::runtime_error("Error: cannot open forwarding file '" + filename + "'");
-        return file;
+        int iface = -1;
+        static_cast<void>((probeLength<Lens>(dest_ip, iface) || ...));
+        return iface;
     }
 
-    void initializeTables()
+    template <int Len>
+    bool probeLength(uint32_t dest_ip, int &iface) const
     {
-        for (int plen : PREFIX_LENGTHS)
-            tables_[plen] = {};
+        constexpr uint32_t mask = 0xFFFFFFFF << (32 - Len);
+        const uint16_t *match = tables_[Len / 8 - 1].find(dest_ip & mask);
+        if (match)
+            iface = *match;
+        return match != nullptr;
     }
 
-    static bool readEntry(std::ifstream &file, Entry &entry)
+    // Bit b of Mask stands for prefix length (b + 1) * 8; lengths are taken
+    // from the highest bit down so the pack is in longest-first order.
+    template <unsigned Mask, int Bit, int... Lens>
+    static constexpr MatchFn specializedFor()
     {
-        if (!file.read(reinterpret_cast<char *>(&entry), sizeof(entry)))
-            return false;
+        if constexpr (Bit < 0)
+            return &ForwardingTable::matchLengths<Lens...>;
+        else if constexpr ((Mask & (1u << Bit)) != 0)
+            return specializedFor<Mask, Bit - 1, Lens..., (Bit + 1) * 8>();
+        else
+            return specializedFor<Mask, Bit - 1, Lens...>();
+    }
 
-        entry.addr = ntohl(entry.addr);
-        entry.prefix_len = ntohs(entry.prefix_len);
-        entry.iface = ntohs(entry.iface);
-        return true;
+    template <size_t... Masks>
+    static constexpr std::array<MatchFn, sizeof...(Masks)> makeSpecialized(std::index_sequence<Masks...>)
+    {
+        return {specializedFor<Masks, 3>()...};
     }
 
-    static void validateEntry(const Entry &entry)
+    static MatchFn specializedFor(unsigned present)
     {
-        switch (entry.prefix_len)
+        static constexpr std::array<MatchFn, 16> SPECIALIZED = makeSpecialized(std::make_index_sequence<16>());
+        return SPECIALIZED[present];
+    }
+
+    void buildEngine()
+    {
+        if (engine_ == LookupEngine::Specialized)
         {
-        case 8:
-        case 16:
-        case 24:
-        case 32:
+            unsigned present = 0;
+            for (int plen : PREFIX_LENGTHS)
+                if (tables_[tableIndex(plen)].size() > 0)
+                    present |= 1u << tableIndex(plen);
+            specialized_ = specializedFor(present);
             return;
-        default:
-            throw std::runtime_error(
-                "Error: invalid prefix length (" + std::to_string(entry.prefix_len) + ")");
+        }
+        if (engine_ == LookupEngine::LengthSearch)
+        {
+            std::vector<LengthSearchIndex::Prefix> prefixes;
+            for (int plen : PREFIX_LENGTHS)
+                tables_[tableIndex(plen)].forEach([&](uint32_t prefix, uint16_t iface)
+                                                  { prefixes.push_back({prefix, plen, iface}); });
+            length_search_ = LengthSearchIndex(prefixes);
+            return;
+        }
+        if (engine_ != LookupEngine::Bloom)
+            return;
+
+        for (int plen : PREFIX_LENGTHS)
+        {
+            PrefixBloomFilter &bloom = blooms_[tableIndex(plen)];
+            const FlatPrefixTable<uint16_t> &table = tables_[tableIndex(plen)];
+            bloom = PrefixBloomFilter(table.size());
+            table.forEach([&](uint32_t prefix, uint16_t)
+                          { bloom.add(prefix); });
         }
     }
 
-    static void checkDuplicate(const Entry &entry, uint32_t masked,
-                               std::set<std::pair<uint32_t, uint16_t>> &seen_prefixes)
+    // The whole forwarding file: mmap()ed when it is a regular file,
+    // otherwise (a pipe, say) read into memory.
+    class MappedFile
     {
-        auto key = std::make_pair(masked, entry.prefix_len);
-        if (!seen_prefixes.insert(key).second)
+    public:
+        explicit MappedFile(const std::string &filename)
+        {
+            int fd = open(filename.c_str(), O_RDONLY);
+            if (fd < 0)
+                throw std::runtime_error("Error: cannot open forwarding file '" + filename + "'");
+
+            struct stat st;
+            if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+            {
+                void *map = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (map != MAP_FAILED)
+                {
+                    map_ = map;
+                    size_ = static_cast<size_t>(st.st_size);
+                    close(fd);
+                    return;
+                }
+            }
+
+            char chunk[1 << 16];
+            ssize_t got;
+            while ((got = read(fd, chunk, sizeof(chunk))) > 0)
+                buffer_.insert(buffer_.end(), chunk, chunk + got);
+            close(fd);
+            size_ = buffer_.size();
+        }
+
+        ~MappedFile()
         {
+            if (map_)
+                munmap(map_, size_);
+        }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        const unsigned char *data() const noexcept
+        {
+            return map_ ? static_cast<const unsigned char *>(map_) : buffer_.data();
+        }
+        size_t size() const noexcept { return size_; }
+
+    private:
+        void *map_ = nullptr;
+        size_t size_ = 0;
+        std::vector<unsigned char> buffer_;
+    };
+
+    // Runs fn(0) .. fn(tasks - 1), each on its own thread when parallel.
+    template <typename Fn>
+    static void runTasks(size_t tasks, bool parallel, Fn fn)
+    {
+        if (!parallel || tasks < 2)
+        {
+            for (size_t t = 0; t < tasks; ++t)
+                fn(t);
+            return;
+        }
+
+        std::vector<std::thread> threads;
+        for (size_t t = 1; t < tasks; ++t)
+            threads.emplace_back(fn, t);
+        fn(0);
+        for (std::thread &thread : threads)
+            thread.join();
+    }
+
+    // Splits [0, count) into one contiguous chunk per hardware thread (but
+    // at least PARALLEL_MIN entries each), runs scan(begin, end) on every
+    // chunk in parallel and returns the smallest result.
+    template <typename Scan>
+    static size_t firstInChunks(size_t count, Scan scan)
+    {
+        size_t chunks = std::min<size_t>(std::thread::hardware_concurrency(), count / PARALLEL_MIN);
+        chunks = std::max<size_t>(chunks, 1);
+
+        std::vector<size_t> results(chunks);
+        runTasks(chunks, true, [&](size_t c)
+                 { results[c] = scan(count * c / chunks, count * (c + 1) / chunks); });
+        return *std::min_element(results.begin(), results.end());
+    }
+
+    // all_entries_ holds the file in order, and entries [0, first_invalid)
+    // have supported lengths. Builds the four tables on four threads, then
+    // throws the error a sequential load would have hit first, if any.
+    void buildTables(size_t first_invalid)
+    {
+        size_t count = all_entries_.size();
+        std::array<size_t, 4> first_duplicate;
+        runTasks(4, count >= PARALLEL_MIN, [&](size_t t)
+                 { first_duplicate[t] = buildTable(PREFIX_LENGTHS[t], first_invalid); });
+
+        size_t duplicate = *std::min_element(first_duplicate.begin(), first_duplicate.end());
+        if (duplicate < first_invalid)
+        {
+            const Entry &entry = all_entries_[duplicate];
             throw std::runtime_error(
                 "Error: duplicate prefix detected (" +
-                ipToString(masked) + "/" + std::to_string(entry.prefix_len) + ")");
+                ipToString(entry.addr & prefixMask(entry.prefix_len)) + "/" +
+                std::to_string(entry.prefix_len) + ")");
+        }
+        if (first_invalid < count)
+        {
+            throw std::runtime_error(
+                "Error: invalid prefix length (" + std::to_string(all_entries_[first_invalid].prefix_len) + ")");
+        }
+
+        for (Entry &entry : all_entries_)
+            handleDefaultEntry(entry);
+        validateFinalTable();
+    }
+
+    // Fills the plen table from entries [0, limit) in file order and returns
+    // the index of the first entry that repeats an earlier (masked prefix,
+    // length) pair of length plen, or limit if none does.
+    //
+    // Only one thread touches each table, and every pair is checked by the
+    // thread of its length: a non-zero masked prefix is stored under its
+    // own length, so that table answers whether it was seen. Address-0
+    // entries are all stored as 0.0.0.0/8 (later ones replace earlier ones),
+    // so masked prefix 0 is tracked with a flag instead.
+    size_t buildTable(int plen, size_t limit)
+    {
+        FlatPrefixTable<uint16_t> &table = tables_[tableIndex(plen)];
+        uint32_t mask = prefixMask(plen);
+
+        size_t stored = 0;
+        for (size_t i = 0; i < limit; ++i)
+            stored += storedLength(all_entries_[i]) == plen;
+        table.reserve(stored);
+
+        bool zero_seen = false;
+        for (size_t i = 0; i < limit; ++i)
+        {
+            const Entry &entry = all_entries_[i];
+            if (entry.prefix_len == plen)
+            {
+                uint32_t masked = entry.addr & mask;
+                bool seen = masked == 0 ? std::exchange(zero_seen, true) : table.contains(masked);
+                if (seen)
+                    return i;
+            }
+            if (storedLength(entry) == plen)
+                table.insertOrAssign(entry.addr & mask, entry.iface);
         }
+        return limit;
+    }
+
+    static int storedLength(const Entry &entry)
+    {
+        return entry.addr == 0 ? 8 : entry.prefix_len;
+    }
+
+    static bool validLength(uint16_t prefix_len)
+    {
+        return prefix_len == 8 || prefix_len == 16 || prefix_len == 24 || prefix_len == 32;
     }
 
     void handleDefaultEntry(Entry &entry)
@@ -245,18 +577,17 @@ private:
         }
     }
 
-    void storeEntry(const Entry &entry, uint32_t masked)
-    {
-        tables_[entry.prefix_len][masked] = entry;
-        all_entries_.push_back(entry);
-    }
-
     void validateFinalTable() const
     {
         if (all_entries_.empty() && default_iface_ < 0)
             throw std::runtime_error("Error: forwarding table is empty");
     }
 
+    static int tableIndex(int prefix_len)
+    {
+        return prefix_len / 8 - 1;
+    }
+
     static uint32_t prefixMask(int prefix_len)
     {
         return prefix_len == 0 ? 0 : 0xFFFFFFFF << (32 - prefix_len);
@@ -0,0 +1,397 @@
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: gen_trace.cpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  Synthetic trace generator for load-testing proj2 -s. It writes records in
+ *  the {sec, usec, iphdr} format of trace_record.hpp with a controlled mix
+ *  of the packet classes simulatePackets distinguishes:
+ *   -c : share of records with a bad header checksum   ("drop checksum")
+ *   -e : share of valid records with TTL = 1            ("drop expired")
+ *   -m : share of destinations matching no prefix      ("default N" when the
+ *        table has a default route, "drop unknown" otherwise)
+ *  All remaining records are sent to a host inside a prefix of the given
+ *  forwarding table, picked with Zipf(-z) popularity, which exercises the
+ *  "send N" and interface-0 "drop policy" branches.
+ *
+ *  The output is split into fixed blocks of records. Every block has its own
+ *  random stream derived from the seed and its index, and worker threads
+ *  write finished blocks at their final offset with pwrite(), so the file is
+ *  identical for any -j and arbitrarily large traces stream straight to disk.
+ *
+ *  With -V n the records are VrfTraceRecords tagged with a uniformly random
+ *  VRF id in [0, n), for proj2 -s -V. Destinations are still drawn from the
+ *  one table given with -f.
+ *
+ * Usage:
+ *   ./gen_trace -f forward_file -o trace_file -n records [-j threads]
+ *               [-c pct] [-e pct] [-m pct] [-z skew] [-r pps] [-s seed] [-V vrfs]
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include "forwarding_table.hpp"
+#include "trace_record.hpp"
+
+using namespace std;
+
+struct GenArgs
+{
+    string forward_file;
+    string trace_file;
+    uint64_t records = 0;
+    unsigned threads = thread::hardware_concurrency();
+    double bad_checksum_pct = 1.0;
+    double expired_pct = 1.0;
+    double miss_pct = 5.0;
+    double skew = 1.0;
+    double packets_per_sec = 1'000'000.0;
+    uint64_t seed = 1;
+    uint32_t vrfs = 0;
+};
+
+/*
+ * Walker/Vose alias table: O(1) sampling from a fixed discrete distribution,
+ * which keeps Zipf-popular prefix selection cheap for billions of records.
+ */
+class AliasTable
+{
+public:
+    explicit AliasTable(const vector<double> &weights)
+        : prob_(weights.size()), alias_(weights.size())
+    {
+        size_t n = weights.size();
+        double total = 0;
+        for (double w : weights)
+            total += w;
+
+        vector<double> scaled(n);
+        vector<size_t> small, large;
+        for (size_t i = 0; i < n; ++i)
+        {
+            scaled[i] = weights[i] * n / total;
+            (scaled[i] < 1.0 ? small : large).push_back(i);
+        }
+
+        while (!small.empty() && !large.empty())
+        {
+            size_t s = small.back(), l = large.back();
+            small.pop_back();
+            prob_[s] = scaled[s];
+            alias_[s] = l;
+            scaled[l] -= 1.0 - scaled[s];
+            if (scaled[l] < 1.0)
+            {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+        for (size_t i : large)
+            prob_[i] = 1.0;
+        for (size_t i : small)
+            prob_[i] = 1.0;
+    }
+
+    template <typename Rng>
+    size_t sample(Rng &rng) const
+    {
+        size_t i = rng() % prob_.size();
+        return uniform_real_distribution<double>(0.0, 1.0)(rng) < prob_[i] ? i : alias_[i];
+    }
+
+private:
+    vector<double> prob_;
+    vector<size_t> alias_;
+};
+
+struct DestinationModel
+{
+    vector<ForwardingTable::Entry> prefixes;
+    AliasTable popularity;
+    vector<uint32_t> misses;
+};
+
+void usage(const char *progname)
+{
+    cerr << "Usage: " << progname << " -f forward_file -o trace_file -n records [-j threads]\n"
+         << "          [-c pct] [-e pct] [-m pct] [-z skew] [-r pps] [-s seed] [-V vrfs]\n"
+         << "  -c : Percent of records with a bad checksum (default 1)\n"
+         << "  -e : Percent of records with TTL = 1 (default 1)\n"
+         << "  -m : Percent of destinations matching no prefix (default 5)\n"
+         << "  -z : Zipf exponent of prefix popularity, 0 = uniform (default 1)\n"
+         << "  -r : Packets per second used for timestamps (default 1000000)\n"
+         << "  -s : Random seed (default 1)\n"
+         << "  -j : Worker threads, 1 to 1024 (default: number of cores)\n"
+         << "  -V : Write VRF-tagged records with ids in [0, vrfs) for proj2 -s -V\n";
+    exit(EXIT_FAILURE);
+}
+
+bool parseThreads(const string &text, unsigned &threads)
+{
+    if (text.empty() || text.size() > 4 || text.find_first_not_of("0123456789") != string::npos)
+        return false;
+    threads = static_cast<unsigned>(stoul(text));
+    return threads > 0 && threads <= 1024;
+}
+
+void parseArgs(int argc, char *argv[], GenArgs &args)
+{
+    int opt;
+    while ((opt = getopt(argc, argv, "f:o:n:j:c:e:m:z:r:s:V:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'f':
+            args.forward_file = optarg;
+            break;
+        case 'o':
+            args.trace_file = optarg;
+            break;
+        case 'n':
+            args.records = strtoull(optarg, nullptr, 10);
+            break;
+        case 'j':
+            if (!parseThreads(optarg, args.threads))
+            {
+                cerr << "Error: -j needs a thread count from 1 to 1024\n";
+                usage(argv[0]);
+            }
+            break;
+        case 'c':
+            args.bad_checksum_pct = atof(optarg);
+            break;
+        case 'e':
+            args.expired_pct = atof(optarg);
+            break;
+        case 'm':
+            args.miss_pct = atof(optarg);
+            break;
+        case 'z':
+            args.skew = atof(optarg);
+            break;
+        case 'r':
+            args.packets_per_sec = atof(optarg);
+            break;
+        case 's':
+            args.seed = strtoull(optarg, nullptr, 10);
+            break;
+        case 'V':
+            args.vrfs = static_cast<uint32_t>(strtoul(optarg, nullptr, 10));
+            if (args.vrfs == 0)
+                usage(argv[0]);
+            break;
+        default:
+            usage(argv[0]);
+        }
+    }
+
+    if (args.forward_file.empty() || args.trace_file.empty() || args.records == 0)
+        usage(argv[0]);
+
+    if (args.bad_checksum_pct < 0 || args.expired_pct < 0 || args.miss_pct < 0 || args.skew < 0 ||
+        args.bad_checksum_pct + args.expired_pct + args.miss_pct > 100.0 || args.packets_per_sec <= 0)
+    {
+        cerr << "Error: percentages must be non-negative and sum to at most 100\n";
+        usage(argv[0]);
+    }
+
+    if (args.threads == 0)
+        args.threads = 1;
+}
+
+uint64_t splitmix64(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+vector<double> zipfWeights(size_t n, double skew)
+{
+    vector<double> weights(n);
+    for (size_t r = 0; r < n; ++r)
+        weights[r] = 1.0 / pow(static_cast<double>(r + 1), skew);
+    return weights;
+}
+
+vector<uint32_t> findMisses(const ForwardingTable &ft, uint64_t seed, size_t wanted)
+{
+    constexpr size_t MAX_ATTEMPTS = 1 << 24;
+
+    mt19937_64 rng(splitmix64(seed ^ 0x6D69737365735FULL));
+    vector<uint32_t> misses;
+    for (size_t attempt = 0; attempt < MAX_ATTEMPTS && misses.size() < wanted; ++attempt)
+    {
+        uint32_t ip = static_cast<uint32_t>(rng());
+        bool is_default = false;
+        if (ft.lookup(ip, is_default) < 0 || is_default)
+            misses.push_back(ip);
+    }
+    return misses;
+}
+
+DestinationModel buildModel(const ForwardingTable &ft, const GenArgs &args)
+{
+    vector<ForwardingTable::Entry> prefixes = ft.entries();
+    if (prefixes.empty())
+    {
+        cerr << "Error: forwarding table has no prefixes to draw destinations from\n";
+        exit(EXIT_FAILURE);
+    }
+
+    // Popularity rank is a seeded shuffle so it is unrelated to file order.
+    shuffle(prefixes.begin(), prefixes.end(), mt19937_64(args.seed));
+
+    vector<uint32_t> misses;
+    if (args.miss_pct > 0)
+    {
+        misses = findMisses(ft, args.seed, 1 << 16);
+        if (misses.empty())
+        {
+            cerr << "Error: forwarding table covers every address; use -m 0\n";
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    AliasTable popularity(zipfWeights(prefixes.size(), args.skew));
+    return {move(prefixes), move(popularity), move(misses)};
+}
+
+void fillRecord(TraceRecord &rec, uint64_t index, mt19937_64 &rng,
+                const DestinationModel &model, const GenArgs &args)
+{
+    static constexpr uint8_t PROTOCOLS[4] = {IPPROTO_TCP, IPPROTO_TCP, IPPROTO_UDP, IPPROTO_ICMP};
+    constexpr uint64_t START_USEC = 1'700'000'000ULL * 1'000'000ULL;
+
+    uint64_t ts = START_USEC + static_cast<uint64_t>(index * (1e6 / args.packets_per_sec));
+    rec.sec = htonl(static_cast<uint32_t>(ts / 1'000'000));
+    rec.usec = htonl(static_cast<uint32_t>(ts % 1'000'000));
+
+    double u = uniform_real_distribution<double>(0.0, 100.0)(rng);
+    bool bad_checksum = u < args.bad_checksum_pct;
+    bool expired = !bad_checksum && u < args.bad_checksum_pct + args.expired_pct;
+    bool miss = !bad_checksum && !expired &&
+                u < args.bad_checksum_pct + args.expired_pct + args.miss_pct;
+
+    uint32_t dest;
+    if (miss)
+    {
+        dest = model.misses[rng() % model.misses.size()];
+    }
+    else
+    {
+        const auto &e = model.prefixes[model.popularity.sample(rng)];
+        uint32_t mask = e.prefix_len >= 32 ? 0xFFFFFFFF : ~(0xFFFFFFFFu >> e.prefix_len);
+        dest = (e.addr & mask) | (static_cast<uint32_t>(rng()) & ~mask);
+    }
+
+    uint16_t checksum = TRACE_VALID_CHECKSUM;
+    if (bad_checksum)
+        while (checksum == TRACE_VALID_CHECKSUM)
+            checksum = static_cast<uint16_t>(rng());
+
+    iphdr &hdr = rec.hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.version = 4;
+    hdr.ihl = 5;
+    hdr.tot_len = htons(static_cast<uint16_t>(40 + rng() % 1461));
+    hdr.id = htons(static_cast<uint16_t>(index));
+    hdr.ttl = expired ? 1 : static_cast<uint8_t>(2 + rng() % 63);
+    hdr.protocol = PROTOCOLS[rng() % 4];
+    hdr.check = htons(checksum);
+    hdr.saddr = htonl(static_cast<uint32_t>(rng()));
+    hdr.daddr = htonl(dest);
+}
+
+void writeBlocks(int fd, const DestinationModel &model, const GenArgs &args,
+                 atomic<uint64_t> &next_block, atomic<bool> &failed)
+{
+    constexpr uint64_t BLOCK_RECORDS = 1 << 16;
+
+    vector<TraceRecord> buffer(BLOCK_RECORDS);
+    vector<VrfTraceRecord> tagged(args.vrfs ? BLOCK_RECORDS : 0);
+    size_t record_size = args.vrfs ? sizeof(VrfTraceRecord) : sizeof(TraceRecord);
+    uint64_t blocks = (args.records + BLOCK_RECORDS - 1) / BLOCK_RECORDS;
+
+    for (uint64_t block = next_block++; block < blocks && !failed; block = next_block++)
+    {
+        mt19937_64 rng(splitmix64(args.seed + block));
+        uint64_t first = block * BLOCK_RECORDS;
+        uint64_t count = min(BLOCK_RECORDS, args.records - first);
+
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            if (args.vrfs)
+            {
+                fillRecord(tagged[i].record, first + i, rng, model, args);
+                tagged[i].vrf = htonl(static_cast<uint32_t>(rng() % args.vrfs));
+            }
+            else
+            {
+                fillRecord(buffer[i], first + i, rng, model, args);
+            }
+        }
+
+        const char *data = args.vrfs ? reinterpret_cast<const char *>(tagged.data())
+                                     : reinterpret_cast<const char *>(buffer.data());
+        size_t remaining = count * record_size;
+        off_t offset = static_cast<off_t>(first * record_size);
+        while (remaining > 0)
+        {
+            ssize_t n = pwrite(fd, data, remaining, offset);
+            if (n <= 0)
+            {
+                failed = true;
+                return;
+            }
+            data += n;
+            remaining -= n;
+            offset += n;
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    GenArgs args;
+    parseArgs(argc, argv, args);
+
+    ForwardingTable ft(args.forward_file);
+    DestinationModel model = buildModel(ft, args);
+
+    int fd = open(args.trace_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        cerr << "Error: Cannot open file '" << args.trace_file << "'\n";
+        return EXIT_FAILURE;
+    }
+
+    atomic<uint64_t> next_block{0};
+    atomic<bool> failed{false};
+    vector<thread> workers;
+    for (unsigned t = 0; t < args.threads; ++t)
+        workers.emplace_back(writeBlocks, fd, cref(model), cref(args), ref(next_block), ref(failed));
+    for (auto &w : workers)
+        w.join();
+
+    if (failed || close(fd) != 0)
+    {
+        cerr << "Error: write to '" << args.trace_file << "' failed\n";
+        return EXIT_FAILURE;
+    }
+
+    return 0;
+}
@@ -0,0 +1,265 @@
+#ifndef HUGE_PAGES_HPP
+#define HUGE_PAGES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <string>
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: huge_pages.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  Optional huge-page backing for the large arrays of the lookup structures
+ *  (FlatPrefixTable slots, Bloom filter words, VRF trie nodes), so that a
+ *  lookup into a table of many megabytes costs a cache miss but rarely also
+ *  a TLB miss.
+ *
+ * =============================================================================
+ *  Policy (HugePages::configure, set once before any table is built):
+ *    - Disabled (default): HugePageAllocator is plain operator new/delete.
+ *    - Enabled: allocations of at least MIN_BYTES are mmap()ed in 2 MiB
+ *      multiples, trying in order
+ *        1. explicit huge pages (MAP_HUGETLB, needs vm.nr_hugepages),
+ *        2. transparent huge pages (a 2 MiB aligned mapping with
+ *           madvise(MADV_HUGEPAGE), needs THP "madvise" or "always"),
+ *        3. ordinary 4 KiB pages from the same aligned mapping.
+ *      Smaller allocations stay on the heap; they span few pages anyway.
+ *    - With a NUMA node, mapped regions get an MPOL_PREFERRED policy for
+ *      that node before their first touch, so the pages land next to the
+ *      thread doing the lookups.
+ *
+ *  Every mapped region is recorded with the backing it got, which usage()
+ *  reports. For THP the madvise only asks; transparentResidentBytes()
+ *  reads /proc/self/smaps to see how much is in huge pages right now.
+ * =============================================================================
+ */
+
+enum class PageBacking
+{
+    Heap,
+    Small,
+    Transparent,
+    Explicit
+};
+
+inline const char *pageBackingName(PageBacking backing)
+{
+    switch (backing)
+    {
+    case PageBacking::Explicit:
+        return "hugetlb";
+    case PageBacking::Transparent:
+        return "thp";
+    case PageBacking::Small:
+        return "4k";
+    default:
+        return "heap";
+    }
+}
+
+class HugePages
+{
+public:
+    static constexpr size_t HUGE_PAGE = 2 << 20;
+    static constexpr size_t MIN_BYTES = 1 << 20;
+    static constexpr int BACKINGS = 4;
+
+    struct Usage
+    {
+        size_t bytes[BACKINGS] = {};
+        size_t regions[BACKINGS] = {};
+    };
+
+    static void configure(bool enabled, int numa_node = -1)
+    {
+        std::lock_guard<std::mutex> lock(state().mutex);
+        state().enabled = enabled;
+        state().numa_node = numa_node;
+    }
+
+    static bool enabled() { return state().enabled; }
+    static int numaNode() { return state().numa_node; }
+
+    static void *allocate(size_t bytes)
+    {
+        State &s = state();
+        if (!s.enabled || bytes < MIN_BYTES)
+            return ::operator new(bytes);
+
+        size_t length = (bytes + HUGE_PAGE - 1) & ~(HUGE_PAGE - 1);
+        PageBacking backing = PageBacking::Explicit;
+        void *addr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (addr == MAP_FAILED)
+        {
+            addr = mapAligned(length);
+            if (addr == nullptr)
+                throw std::bad_alloc();
+            backing = madvise(addr, length, MADV_HUGEPAGE) == 0 ? PageBacking::Transparent : PageBacking::Small;
+        }
+        if (s.numa_node >= 0)
+            preferNode(addr, length, s.numa_node);
+
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.regions[addr] = {length, backing};
+        s.usage.bytes[static_cast<int>(backing)] += length;
+        ++s.usage.regions[static_cast<int>(backing)];
+        return addr;
+    }
+
+    static void deallocate(void *addr, size_t bytes) noexcept
+    {
+        State &s = state();
+        if (bytes >= MIN_BYTES)
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            auto it = s.regions.find(addr);
+            if (it != s.regions.end())
+            {
+                munmap(addr, it->second.length);
+                s.usage.bytes[static_cast<int>(it->second.backing)] -= it->second.length;
+                --s.usage.regions[static_cast<int>(it->second.backing)];
+                s.regions.erase(it);
+                return;
+            }
+        }
+        ::operator delete(addr);
+    }
+
+    // Mapped regions currently alive, by backing (Heap is never counted).
+    static Usage usage()
+    {
+        std::lock_guard<std::mutex> lock(state().mutex);
+        return state().usage;
+    }
+
+    // Bytes of the transparent-huge-page regions currently backed by huge
+    // pages, from the AnonHugePages lines of /proc/self/smaps.
+    static size_t transparentResidentBytes()
+    {
+        std::map<uintptr_t, uintptr_t> thp;
+        {
+            std::lock_guard<std::mutex> lock(state().mutex);
+            for (const auto &[addr, region] : state().regions)
+                if (region.backing == PageBacking::Transparent)
+                    thp[reinterpret_cast<uintptr_t>(addr)] = reinterpret_cast<uintptr_t>(addr) + region.length;
+        }
+        if (thp.empty())
+            return 0;
+
+        std::ifstream smaps("/proc/self/smaps");
+        std::string line;
+        bool counted = false;
+        size_t total = 0;
+        while (std::getline(smaps, line))
+        {
+            unsigned long start, end;
+            size_t kib;
+            if (std::sscanf(line.c_str(), "%lx-%lx ", &start, &end) == 2 && line.find(' ') > line.find('-'))
+            {
+                auto it = thp.upper_bound(start);
+                counted = (it != thp.end() && it->first < end) ||
+                          (it != thp.begin() && std::prev(it)->second > start);
+            }
+            else if (counted && std::sscanf(line.c_str(), "AnonHugePages: %zu kB", &kib) == 1)
+            {
+                total += kib * 1024;
+            }
+        }
+        return total;
+    }
+
+    // NUMA node of a CPU, or -1 if the kernel does not say.
+    static int cpuNode(int cpu)
+    {
+        for (int node = 0; node < 1024; ++node)
+        {
+            std::ostringstream path;
+            path << "/sys/devices/system/cpu/cpu" << cpu << "/node" << node;
+            if (access(path.str().c_str(), F_OK) == 0)
+                return node;
+        }
+        return -1;
+    }
+
+private:
+    struct Region
+    {
+        size_t length;
+        PageBacking backing;
+    };
+
+    struct State
+    {
+        std::mutex mutex;
+        bool enabled = false;
+        int numa_node = -1;
+        std::map<void *, Region> regions;
+        Usage usage;
+    };
+
+    static State &state()
+    {
+        static State s;
+        return s;
+    }
+
+    // A 2 MiB aligned anonymous mapping of length bytes, so THP can back
+    // all of it.
+    static void *mapAligned(size_t length)
+    {
+        void *raw = mmap(nullptr, length + HUGE_PAGE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED)
+            return nullptr;
+
+        uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+        uintptr_t aligned = (start + HUGE_PAGE - 1) & ~(HUGE_PAGE - 1);
+        if (aligned > start)
+            munmap(raw, aligned - start);
+        munmap(reinterpret_cast<void *>(aligned + length), start + HUGE_PAGE - aligned);
+        return reinterpret_cast<void *>(aligned);
+    }
+
+    static void preferNode(void *addr, size_t length, int node)
+    {
+        unsigned long mask[16] = {};
+        if (node >= static_cast<int>(sizeof(mask) * 8))
+            return;
+        mask[node / 64] = 1UL << (node % 64);
+        // Only a preference: a failure (no NUMA support) leaves the default.
+        syscall(SYS_mbind, addr, length, MPOL_PREFERRED, mask, sizeof(mask) * 8, 0);
+    }
+};
+
+// std::allocator replacement that routes through HugePages.
+template <typename T>
+struct HugePageAllocator
+{
+    using value_type = T;
+
+    HugePageAllocator() noexcept = default;
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U> &) noexcept {}
+
+    T *allocate(size_t n) { return static_cast<T *>(HugePages::allocate(n * sizeof(T))); }
+    void deallocate(T *p, size_t n) noexcept { HugePages::deallocate(p, n * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U> &) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const HugePageAllocator<U> &) const noexcept { return false; }
+};
+
+#endif
@@ -0,0 +1,198 @@
+#ifndef LENGTH_SEARCH_INDEX_HPP
+#define LENGTH_SEARCH_INDEX_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "flat_prefix_table.hpp"
+
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: length_search_index.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  This class implements binary search on prefix lengths (Waldvogel et al.)
+ *  for longest-prefix matching over any set of IPv4 prefix lengths 1-32.
+ *
+ * =============================================================================
+ *  Class: LengthSearchIndex
+ *  ---------------------------------------------------------------------------
+ *  Structure:
+ *    - lengths_: the distinct prefix lengths present, ascending.
+ *    - tables_:  one FlatPrefixTable per length, mapping a masked prefix to
+ *                its precomputed best matching prefix (bmp): the iface of
+ *                the longest real prefix covering it, or -1 for none.
+ *
+ *  Search:
+ *    Binary search over lengths_. Probing length L with the destination
+ *    masked to L:
+ *      - hit:  some prefix of length >= L may still match; remember the
+ *              entry's bmp and continue with the longer half.
+ *      - miss: no prefix of length >= L can match; continue with the
+ *              shorter half.
+ *    The last bmp remembered is the answer, so a search over n lengths
+ *    costs at most floor(log2 n) + 1 probes: 3 for ForwardingTable's four
+ *    lengths, 6 for all 32.
+ *
+ *  Markers:
+ *    The "hit means go longer" rule needs every prefix to be visible from
+ *    the lengths the search passes on the way to it. For each prefix, each
+ *    shorter length on its binary-search path gets a marker: the prefix
+ *    truncated to that length. Markers carry a bmp like real prefixes, so a
+ *    marker hit that leads to a dead end still returns the right answer
+ *    without backtracking.
+ * =============================================================================
+ */
+class LengthSearchIndex
+{
+public:
+    struct Prefix
+    {
+        uint32_t addr;
+        int prefix_len;
+        int iface;
+    };
+
+    LengthSearchIndex() = default;
+
+    explicit LengthSearchIndex(std::vector<Prefix> prefixes)
+    {
+        collectLengths(prefixes);
+
+        // Callers often pass prefixes in another hash table's slot order,
+        // which would pile up in one corner of the tables built here.
+        // Stable, so a repeated prefix still ends up with its last iface.
+        std::stable_sort(prefixes.begin(), prefixes.end(), byLengthThenPrefix);
+
+        std::vector<FlatPrefixTable<int32_t>> real(lengths_.size());
+        for (const auto &p : prefixes)
+            real[indexOf(p.prefix_len)].insertOrAssign(p.addr & mask(p.prefix_len), p.iface);
+
+        tables_.resize(lengths_.size());
+        for (const auto &p : prefixes)
+        {
+            int target = indexOf(p.prefix_len);
+            uint32_t addr = p.addr & mask(p.prefix_len);
+            tables_[target].insertOrAssign(addr, bestMatch(real, addr, target));
+        }
+
+        for (const auto &p : prefixes)
+        {
+            for (int level : searchPath(indexOf(p.prefix_len)))
+            {
+                uint32_t marker = p.addr & mask(lengths_[level]);
+                if (!tables_[level].contains(marker))
+                {
+                    tables_[level].insertOrAssign(marker, bestMatch(real, marker, level));
+                    ++markers_;
+                }
+            }
+        }
+    }
+
+    // Iface of the longest matching prefix, or -1 if no prefix matches.
+    int match(uint32_t dest_ip) const noexcept
+    {
+        int best = -1;
+        int lo = 0, hi = static_cast<int>(lengths_.size()) - 1;
+        while (lo <= hi)
+        {
+            int mid = (lo + hi) / 2;
+            const int32_t *bmp = tables_[mid].find(dest_ip & mask(lengths_[mid]));
+            if (bmp)
+            {
+                best = *bmp;
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid - 1;
+            }
+        }
+        return best;
+    }
+
+    size_t markers() const noexcept { return markers_; }
+    const std::vector<int> &lengths() const noexcept { return lengths_; }
+
+    int maxProbes() const noexcept
+    {
+        int probes = 0;
+        for (size_t n = lengths_.size(); n > 0; n /= 2)
+            ++probes;
+        return probes;
+    }
+
+private:
+    std::vector<int> lengths_;
+    std::vector<FlatPrefixTable<int32_t>> tables_;
+    size_t markers_ = 0;
+
+    static uint32_t mask(int prefix_len) noexcept
+    {
+        return prefix_len == 0 ? 0 : 0xFFFFFFFF << (32 - prefix_len);
+    }
+
+    static bool byLengthThenPrefix(const Prefix &a, const Prefix &b) noexcept
+    {
+        if (a.prefix_len != b.prefix_len)
+            return a.prefix_len < b.prefix_len;
+        return (a.addr & mask(a.prefix_len)) < (b.addr & mask(b.prefix_len));
+    }
+
+    void collectLengths(const std::vector<Prefix> &prefixes)
+    {
+        for (const auto &p : prefixes)
+        {
+            if (p.prefix_len < 1 || p.prefix_len > 32)
+                throw std::runtime_error("Error: invalid prefix length (" + std::to_string(p.prefix_len) + ")");
+            lengths_.push_back(p.prefix_len);
+        }
+        std::sort(lengths_.begin(), lengths_.end());
+        lengths_.erase(std::unique(lengths_.begin(), lengths_.end()), lengths_.end());
+    }
+
+    int indexOf(int prefix_len) const
+    {
+        return static_cast<int>(std::lower_bound(lengths_.begin(), lengths_.end(), prefix_len) - lengths_.begin());
+    }
+
+    // Levels where a search for lengths_[target] hits and turns longer.
+    std::vector<int> searchPath(int target) const
+    {
+        std::vector<int> path;
+        int lo = 0, hi = static_cast<int>(lengths_.size()) - 1;
+        while (lo <= hi)
+        {
+            int mid = (lo + hi) / 2;
+            if (mid == target)
+                break;
+            if (mid < target)
+            {
+                path.push_back(mid);
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid - 1;
+            }
+        }
+        return path;
+    }
+
+    // Iface of the longest real prefix covering addr with a length of at
+    // most lengths_[level], or -1.
+    int32_t bestMatch(const std::vector<FlatPrefixTable<int32_t>> &real, uint32_t addr, int level) const
+    {
+        for (int i = level; i >= 0; --i)
+            if (const int32_t *iface = real[i].find(addr & mask(lengths_[i])))
+                return *iface;
+        return -1;
+    }
+};
+
+#endif
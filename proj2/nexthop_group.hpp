@@ -0,0 +1,287 @@
+#ifndef NEXTHOP_GROUP_HPP
+#define NEXTHOP_GROUP_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: nexthop_group.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  This code implements equal/weighted-cost multipath (ECMP) next-hop
+ *  groups. A forwarding entry whose iface is a group id is spread over the
+ *  group's member interfaces, one flow hash per packet picking the member.
+ *
+ * =============================================================================
+ *  Class: NextHopGroupTable
+ *  ---------------------------------------------------------------------------
+ *  Group file format (one directive per line, '#' starts a comment):
+ *
+ *      group <id> [resilient] <iface>[:<weight>] ...
+ *      down  <id> <iface>
+ *
+ *    - id is the interface number used by forwarding entries (1-65535).
+ *    - weight defaults to 1.
+ *    - "down" takes a member out of service after all groups are built, the
+ *      way a link failure would at runtime.
+ *
+ *    Example:
+ *      group 100 1:3 2:1
+ *      group 200 resilient 4 5 6 7
+ *      down  200 6
+ *
+ *  ---------------------------------------------------------------------------
+ *  Member selection:
+ *  Every group owns BUCKETS hash buckets, each naming one member, and a
+ *  packet uses bucket (flow_hash * BUCKETS) >> 32. Members own a share of
+ *  buckets proportional to their weight, so every packet of a flow keeps
+ *  the same member while the membership is unchanged.
+ *    - Hash-threshold (default): members own contiguous bucket ranges. When
+ *      a member goes down the ranges are recomputed, which moves flows of
+ *      surviving members too.
+ *    - Resilient: only the buckets of the failed member are handed out, to
+ *      the survivors furthest below their weighted share; flows on the
+ *      surviving members never move.
+ * =============================================================================
+ */
+class NextHopGroup
+{
+public:
+    static constexpr uint32_t BUCKETS = 4096;
+
+    struct Member
+    {
+        uint16_t iface;
+        uint32_t weight;
+        bool up;
+    };
+
+    NextHopGroup(uint16_t id, bool resilient, std::vector<Member> members)
+        : id_(id), resilient_(resilient), members_(std::move(members)), buckets_(BUCKETS)
+    {
+        fillContiguous();
+    }
+
+    // Returns the member index for a flow hash, or -1 if no member is up.
+    int select(uint32_t flow_hash) const
+    {
+        if (live_members_ == 0)
+            return -1;
+        return buckets_[(static_cast<uint64_t>(flow_hash) * BUCKETS) >> 32];
+    }
+
+    bool takeDown(uint16_t iface)
+    {
+        auto it = std::find_if(members_.begin(), members_.end(), [&](const Member &m)
+                               { return m.iface == iface && m.up; });
+        if (it == members_.end())
+            return false;
+
+        it->up = false;
+        if (resilient_)
+            redistribute(static_cast<uint16_t>(it - members_.begin()));
+        else
+            fillContiguous();
+        return true;
+    }
+
+    uint16_t id() const noexcept { return id_; }
+    bool resilient() const noexcept { return resilient_; }
+    const std::vector<Member> &members() const noexcept { return members_; }
+
+private:
+    uint16_t id_;
+    bool resilient_;
+    std::vector<Member> members_;
+    std::vector<uint16_t> buckets_;
+    size_t live_members_ = 0;
+
+    uint64_t liveWeight() const
+    {
+        uint64_t total = 0;
+        for (const auto &m : members_)
+            if (m.up)
+                total += m.weight;
+        return total;
+    }
+
+    void fillContiguous()
+    {
+        live_members_ = std::count_if(members_.begin(), members_.end(), [](const Member &m)
+                                      { return m.up; });
+        uint64_t total = liveWeight();
+        if (total == 0)
+            return;
+
+        uint64_t cumulative = 0;
+        uint32_t bucket = 0;
+        for (size_t i = 0; i < members_.size(); ++i)
+        {
+            if (!members_[i].up)
+                continue;
+            cumulative += members_[i].weight;
+            uint32_t end = static_cast<uint32_t>(cumulative * BUCKETS / total);
+            for (; bucket < end; ++bucket)
+                buckets_[bucket] = static_cast<uint16_t>(i);
+        }
+    }
+
+    void redistribute(uint16_t failed)
+    {
+        --live_members_;
+        uint64_t total = liveWeight();
+        if (total == 0)
+            return;
+
+        // Down members never win the argmax below, even once every live
+        // member has reached its rounded-down share and the deficits tie.
+        std::vector<int64_t> deficit(members_.size(), INT64_MIN);
+        for (size_t i = 0; i < members_.size(); ++i)
+            if (members_[i].up)
+                deficit[i] = static_cast<int64_t>(members_[i].weight * BUCKETS / total);
+        for (uint16_t owner : buckets_)
+            if (members_[owner].up)
+                --deficit[owner];
+
+        for (auto &owner : buckets_)
+        {
+            if (owner != failed)
+                continue;
+            size_t best = std::max_element(deficit.begin(), deficit.end()) - deficit.begin();
+            owner = static_cast<uint16_t>(best);
+            --deficit[best];
+        }
+    }
+};
+
+class NextHopGroupTable
+{
+public:
+    explicit NextHopGroupTable(const std::string &filename)
+        : group_index_(65536, -1)
+    {
+        loadFromFile(filename);
+    }
+
+    bool isGroup(int iface) const noexcept
+    {
+        return iface >= 0 && iface < 65536 && group_index_[iface] >= 0;
+    }
+
+    const NextHopGroup &group(int iface) const { return groups_[group_index_[iface]]; }
+    int groupIndex(int iface) const { return group_index_[iface]; }
+    const std::vector<NextHopGroup> &groups() const noexcept { return groups_; }
+
+private:
+    struct Down
+    {
+        int line_no;
+        int group;
+        uint16_t iface;
+    };
+
+    std::vector<NextHopGroup> groups_;
+    std::vector<int> group_index_;
+
+    void loadFromFile(const std::string &filename)
+    {
+        std::ifstream file(filename);
+        if (!file.is_open())
+            throw std::runtime_error("Error: cannot open group file '" + filename + "'");
+
+        std::vector<Down> downs;
+        std::string line;
+        int line_no = 0;
+        while (std::getline(file, line))
+        {
+            ++line_no;
+            std::istringstream in(line.substr(0, line.find('#')));
+            std::string directive;
+            if (!(in >> directive))
+                continue;
+
+            if (directive == "group")
+                parseGroup(in, line_no);
+            else if (directive == "down")
+                downs.push_back(parseDown(in, line_no));
+            else
+                throw parseError(line_no, "unknown directive '" + directive + "'");
+        }
+
+        for (const auto &down : downs)
+        {
+            if (group_index_[down.group] < 0)
+                throw parseError(down.line_no, "unknown group " + std::to_string(down.group));
+            if (!groups_[group_index_[down.group]].takeDown(down.iface))
+                throw parseError(down.line_no, "interface " + std::to_string(down.iface) + " is not an active member");
+        }
+    }
+
+    void parseGroup(std::istringstream &in, int line_no)
+    {
+        std::string token;
+        int id = 0;
+        if (!(in >> token) || !parseNumber(token, 1, 65535, id))
+            throw parseError(line_no, "bad group id");
+        if (group_index_[id] >= 0)
+            throw parseError(line_no, "duplicate group " + std::to_string(id));
+
+        bool resilient = false;
+        std::vector<NextHopGroup::Member> members;
+        while (in >> token)
+        {
+            if (token == "resilient" && members.empty() && !resilient)
+            {
+                resilient = true;
+                continue;
+            }
+
+            size_t colon = token.find(':');
+            int iface = 0, weight = 1;
+            if (!parseNumber(token.substr(0, colon), 0, 65535, iface) ||
+                (colon != std::string::npos && !parseNumber(token.substr(colon + 1), 1, 1'000'000, weight)))
+                throw parseError(line_no, "bad member '" + token + "'");
+            members.push_back({static_cast<uint16_t>(iface), static_cast<uint32_t>(weight), true});
+        }
+
+        if (members.empty() || members.size() > NextHopGroup::BUCKETS)
+            throw parseError(line_no, "group needs 1 to " + std::to_string(NextHopGroup::BUCKETS) + " members");
+
+        group_index_[id] = static_cast<int>(groups_.size());
+        groups_.emplace_back(static_cast<uint16_t>(id), resilient, std::move(members));
+    }
+
+    static Down parseDown(std::istringstream &in, int line_no)
+    {
+        std::string group_text, iface_text, extra;
+        int id = 0, iface = 0;
+        if (!(in >> group_text >> iface_text) || (in >> extra) ||
+            !parseNumber(group_text, 1, 65535, id) || !parseNumber(iface_text, 0, 65535, iface))
+            throw parseError(line_no, "expected 'down <group> <iface>'");
+        return {line_no, id, static_cast<uint16_t>(iface)};
+    }
+
+    static bool parseNumber(const std::string &text, int min, int max, int &value)
+    {
+        if (text.empty() || text.size() > 7 ||
+            !std::all_of(text.begin(), text.end(), [](char c)
+                         { return c >= '0' && c <= '9'; }))
+            return false;
+        value = std::stoi(text);
+        return value >= min && value <= max;
+    }
+
+    static std::runtime_error parseError(int line_no, const std::string &what)
+    {
+        return std::runtime_error("Error: invalid group file line " + std::to_string(line_no) + " (" + what + ")");
+    }
+};
+
+#endif
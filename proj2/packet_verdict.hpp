@@ -0,0 +1,168 @@
+#ifndef PACKET_VERDICT_HPP
+#define PACKET_VERDICT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: packet_verdict.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  Allocation-free representation of a simulated packet's fate and the
+ *  formatter that turns it into proj2 -s output lines.
+ *
+ * =============================================================================
+ *  PacketVerdict:
+ *    An action code plus the interface for "send"/"default", 4 bytes in
+ *    place of the std::string the simulator used to build per packet.
+ *    PacketAction::Route means no decision yet (the packet passed the
+ *    checks that need no lookup).
+ *
+ *  formatVerdictLine():
+ *    Writes "<sec>.<usec> <action>\n" exactly as
+ *        cout << fixed << setprecision(6) << (sec + usec / 1e6)
+ *    would, using integer arithmetic only: the microsecond total is split
+ *    into whole seconds and six fractional digits, so usec values of one
+ *    million or more carry into the seconds like the double sum did. (The
+ *    double is never off by half a microsecond for 32-bit inputs, so the
+ *    integer result always matches the rounded double.)
+ *    Digits are emitted two at a time from a 200-byte table.
+ * =============================================================================
+ */
+
+enum class PacketAction : uint8_t
+{
+    Route,
+    DropChecksum,
+    DropExpired,
+    DropPolicy,
+    Send,
+    Default,
+    DropUnknown
+};
+
+struct PacketVerdict
+{
+    PacketAction action;
+    uint16_t iface;
+};
+
+// Longest line: 10-digit seconds, '.', 6 digits, ' ', "default 65535", '\n'.
+inline constexpr size_t MAX_VERDICT_LINE = 32;
+
+namespace verdict_detail
+{
+    inline constexpr char DIGIT_PAIRS[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+    inline char *appendText(char *out, const char *text, size_t len)
+    {
+        std::memcpy(out, text, len);
+        return out + len;
+    }
+
+    inline char *appendUnsigned(char *out, uint64_t value)
+    {
+        char buffer[20];
+        char *end = buffer + sizeof(buffer);
+        char *p = end;
+        while (value >= 100)
+        {
+            unsigned pair = static_cast<unsigned>(value % 100) * 2;
+            value /= 100;
+            *--p = DIGIT_PAIRS[pair + 1];
+            *--p = DIGIT_PAIRS[pair];
+        }
+        if (value >= 10)
+        {
+            unsigned pair = static_cast<unsigned>(value) * 2;
+            *--p = DIGIT_PAIRS[pair + 1];
+            *--p = DIGIT_PAIRS[pair];
+        }
+        else
+        {
+            *--p = static_cast<char>('0' + value);
+        }
+        return appendText(out, p, static_cast<size_t>(end - p));
+    }
+
+    inline char *appendSixDigits(char *out, uint32_t value)
+    {
+        for (int i = 4; i >= 0; i -= 2)
+        {
+            unsigned pair = (value % 100) * 2;
+            value /= 100;
+            out[i] = DIGIT_PAIRS[pair];
+            out[i + 1] = DIGIT_PAIRS[pair + 1];
+        }
+        return out + 6;
+    }
+}
+
+// sec and usec in host byte order.
+inline char *formatTimestamp(char *out, uint32_t sec, uint32_t usec)
+{
+    uint64_t total = static_cast<uint64_t>(sec) * 1'000'000 + usec;
+    out = verdict_detail::appendUnsigned(out, total / 1'000'000);
+    *out++ = '.';
+    return verdict_detail::appendSixDigits(out, static_cast<uint32_t>(total % 1'000'000));
+}
+
+inline char *formatAction(char *out, PacketVerdict verdict)
+{
+    using verdict_detail::appendText;
+    switch (verdict.action)
+    {
+    case PacketAction::DropChecksum:
+        return appendText(out, "drop checksum", 13);
+    case PacketAction::DropExpired:
+        return appendText(out, "drop expired", 12);
+    case PacketAction::DropPolicy:
+        return appendText(out, "drop policy", 11);
+    case PacketAction::Send:
+        return verdict_detail::appendUnsigned(appendText(out, "send ", 5), verdict.iface);
+    case PacketAction::Default:
+        return verdict_detail::appendUnsigned(appendText(out, "default ", 8), verdict.iface);
+    default:
+        return appendText(out, "drop unknown", 12);
+    }
+}
+
+// The action alone, without the interface ("send", "drop expired", ...).
+inline const char *actionName(PacketAction action)
+{
+    switch (action)
+    {
+    case PacketAction::Route:
+        return "route";
+    case PacketAction::DropChecksum:
+        return "drop checksum";
+    case PacketAction::DropExpired:
+        return "drop expired";
+    case PacketAction::DropPolicy:
+        return "drop policy";
+    case PacketAction::Send:
+        return "send";
+    case PacketAction::Default:
+        return "default";
+    default:
+        return "drop unknown";
+    }
+}
+
+// Writes one complete output line (at most MAX_VERDICT_LINE bytes).
+inline char *formatVerdictLine(char *out, uint32_t sec, uint32_t usec, PacketVerdict verdict)
+{
+    out = formatTimestamp(out, sec, usec);
+    *out++ = ' ';
+    out = formatAction(out, verdict);
+    *out++ = '\n';
+    return out;
+}
+
+#endif
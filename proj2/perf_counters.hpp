@@ -0,0 +1,143 @@
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#ifdef PROJ2_PERF
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: perf_counters.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  Hardware performance counters for the route lookup stage of proj2 -s,
+ *  read with perf_event_open(2). Built only with -DPROJ2_PERF (make PERF=1);
+ *  otherwise every member is an empty inline function and the counters cost
+ *  nothing.
+ *
+ * =============================================================================
+ *  Class: PerfCounters
+ *  ---------------------------------------------------------------------------
+ *  - Counts, for the calling thread and in user mode only: cycles,
+ *    instructions, last-level cache read misses and data TLB read misses.
+ *  - The events are opened as one group so they are scheduled together and
+ *    describe the same instructions. If the PMU has too few counters the
+ *    kernel multiplexes the group; the values are then scaled by
+ *    time_enabled / time_running.
+ *  - start()/stop() enable and disable the whole group with one ioctl each,
+ *    so only the code between them (a batch of lookups) is counted.
+ *  - Events the host does not support (common in VMs, or with a restrictive
+ *    perf_event_paranoid) are left out and reported as unavailable; if none
+ *    can be opened available() is false and start()/stop() do nothing.
+ * =============================================================================
+ */
+class PerfCounters
+{
+public:
+    enum Event
+    {
+        Cycles,
+        Instructions,
+        LlcMisses,
+        DtlbMisses,
+        EVENTS
+    };
+
+    static constexpr const char *EVENT_NAMES[EVENTS] = {"cycles", "instructions", "llc-misses", "dtlb-misses"};
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+#ifdef PROJ2_PERF
+    static constexpr bool ENABLED = true;
+
+    // Counts the thread that constructs the object.
+    PerfCounters()
+    {
+        constexpr uint64_t READ_MISS = PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+        const uint32_t types[EVENTS] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE};
+        const uint64_t configs[EVENTS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                          PERF_COUNT_HW_CACHE_LL | READ_MISS, PERF_COUNT_HW_CACHE_DTLB | READ_MISS};
+
+        for (int e = 0; e < EVENTS; ++e)
+        {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = types[e];
+            attr.config = configs[e];
+            attr.disabled = leader_ < 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader_, 0));
+            if (fd < 0)
+                continue;
+            if (leader_ < 0)
+                leader_ = fd;
+            fds_[e] = fd;
+            slots_[e] = opened_++;
+        }
+    }
+
+    ~PerfCounters()
+    {
+        for (int fd : fds_)
+            if (fd >= 0)
+                close(fd);
+    }
+
+    bool available() const noexcept { return leader_ >= 0; }
+    bool has(Event e) const noexcept { return fds_[e] >= 0; }
+
+    void start() noexcept
+    {
+        if (leader_ >= 0)
+            ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    void stop() noexcept
+    {
+        if (leader_ >= 0)
+            ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    // Scaled total since construction; 0 for unavailable events.
+    double value(Event e) const
+    {
+        if (fds_[e] < 0)
+            return 0;
+
+        // nr, time_enabled, time_running, then one value per opened event.
+        uint64_t data[3 + EVENTS] = {};
+        if (read(leader_, data, sizeof(data)) < static_cast<ssize_t>(3 * sizeof(uint64_t)) || data[2] == 0)
+            return 0;
+        return static_cast<double>(data[3 + slots_[e]]) * static_cast<double>(data[1]) / static_cast<double>(data[2]);
+    }
+
+private:
+    int leader_ = -1;
+    int fds_[EVENTS] = {-1, -1, -1, -1};
+    int slots_[EVENTS] = {};
+    int opened_ = 0;
+#else
+    static constexpr bool ENABLED = false;
+
+    PerfCounters() = default;
+    bool available() const noexcept { return false; }
+    bool has(Event) const noexcept { return false; }
+    void start() noexcept {}
+    void stop() noexcept {}
+    double value(Event) const { return 0; }
+#endif
+};
+
+#endif
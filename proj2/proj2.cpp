@@ -4,50 +4,203 @@
  * Filename: proj2.cpp
  * Date created: 2025-10-07
  * Brief description:
- *  This program simulates a router with three modes:
+ *  This program simulates a router with five modes:
  *   -p : packet printing mode
  *   -r : forwarding table printing mode
  *   -s : simulation mode
+ *   -c : verdict file conversion mode (binary -s output back to text)
+ *   -d : forwarding table diff mode (old and new table given as two -f)
  *
  * Usage:
- *   ./proj2 <-p|-r|-s> [-f forward_file] [-t trace_file]
+ *   ./proj2 <-p|-r|-s|-c|-d> [-f forward_file] [-t trace_file] [-a acl_file]
+ *           [-g group_file] [-q queue_file] [-e engine] [-P cpus] [-b verdict_file]
+ *           [-i seconds] [-w] [-v] [-O] [-V] [-H] [-J] [-R window]
+ *
+ * Simulation mode runs as a pipeline of five threads (reader, validator,
+ * route lookup, formatter, writer) passing batches of packets through
+ * single-producer/single-consumer rings; see simulatePackets().
+ *
+ * With -V every -f names the forwarding table of one VRF (ids 0, 1, ... in
+ * command-line order), the trace holds VRF-tagged records, and all tables
+ * are merged into one VrfForwardingTable that stores shared parts once.
+ *
+ * With -q the packets sent on each interface also pass through a simulated
+ * shaped output queue (egress_queues.hpp); drops and queueing delays are
+ * reported at the end.
+ *
+ * The trace given with -t to -p, -s or -d may also be a pcap or pcapng capture
+ * (Ethernet, VLAN-tagged Ethernet, Linux cooked or raw IP); its IPv4
+ * packets are read in place from an mmap (capture_reader.hpp).
+ *
+ * With -R window the router gathers that many packets (whole pipeline
+ * batches), radix-sorts them by destination (batch_reorder.hpp) and looks
+ * each distinct destination up once; verdicts still come out in trace
+ * order. It pays off when destinations repeat within the window.
+ *
+ * During -s, packets and bytes per verdict action and per interface are
+ * counted live (traffic_counters.hpp). SIGUSR1 prints the current counts
+ * to stderr, -i prints them every few seconds, and -J prints them as JSON;
+ * with any of -v, -i or -J the final counts are printed at the end.
+ *
+ * Built with make PERF=1, -s ends by printing cycles, instructions, LLC and
+ * dTLB misses per million route lookups (perf_counters.hpp).
  */
 
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <cstring>
 #include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
 #include <arpa/inet.h>
 #include <netinet/ip.h>
 #include <unistd.h>
 #include "forwarding_table.hpp"
+#include "acl_classifier.hpp"
+#include "nexthop_group.hpp"
+#include "flow_hash.hpp"
+#include "table_reloader.hpp"
+#include "route_aggregation.hpp"
+#include "spsc_ring.hpp"
+#include "trace_record.hpp"
+#include "packet_verdict.hpp"
+#include "verdict_file.hpp"
+#include "vrf_table.hpp"
+#include "perf_counters.hpp"
+#include "huge_pages.hpp"
+#include "egress_queues.hpp"
+#include "traffic_counters.hpp"
+#include "capture_reader.hpp"
+#include "batch_reorder.hpp"
 
 using namespace std;
 
+// Largest -R window, in packets.
+constexpr size_t MAX_REORDER_WINDOW = 16384;
+
 struct CliArgs
 {
     bool packet_mode = false;
     bool table_mode = false;
     bool sim_mode = false;
+    bool convert_mode = false;
+    bool diff_mode = false;
     string forward_file;
+    vector<string> forward_files;
     string trace_file;
+    string acl_file;
+    string group_file;
+    string queue_file;
+    bool watch = false;
+    bool verbose = false;
+    bool aggregate = false;
+    bool vrf = false;
+    bool huge_pages = false;
+    unsigned stats_interval = 0;
+    bool stats_json = false;
+    size_t reorder_window = 0;
+    ForwardingTable::LookupEngine engine = ForwardingTable::LookupEngine::Hash;
+    vector<int> cpus;
+    string verdict_file;
+};
+
+struct SimContext
+{
+    const ForwardingTable *ft = nullptr;
+    const VrfForwardingTable *vrfs = nullptr;
+    const AclClassifier *acl = nullptr;
+    const NextHopGroupTable *groups = nullptr;
+    vector<vector<uint64_t>> member_packets;
 };
 
 void usage(const char *progname)
 {
-    cerr << "Usage: " << progname << " <-p|-r|-s> [-f forward_file] [-t trace_file]\n"
+    cerr << "Usage: " << progname << " <-p|-r|-s|-c|-d> [-f forward_file] [-t trace_file] [-a acl_file]\n"
+         << "       [-g group_file] [-q queue_file] [-e engine] [-P cpus] [-b verdict_file]\n"
+         << "       [-i seconds] [-w] [-v] [-O] [-V] [-H] [-J] [-R window]\n"
          << "  -p : Packet printing mode (requires -t)\n"
          << "  -r : Forwarding table printing mode (requires -f)\n"
-         << "  -s : Simulation mode (requires -f and -t)\n";
+         << "  -s : Simulation mode (requires -f and -t)\n"
+         << "  -c : Print the binary verdict file given with -b as simulation text output\n"
+         << "  -d : Print the address ranges whose route differs between two -f tables (old, new);\n"
+         << "       with -t also count the trace packets they affect\n"
+         << "  -t : trace_file may also be a pcap or pcapng capture; its IPv4 packets are used (with -p, -s or -d)\n"
+         << "  -a : Drop packets denied by the ACL rules in acl_file (with -s)\n"
+         << "  -g : Spread routes to group ids over the ECMP groups in group_file (with -s)\n"
+         << "  -q : Simulate the shaped output queues in queue_file and report drops and delays (with -s)\n"
+         << "  -e : Lookup engine: hash (default), bloom, bsl or spec (with -s)\n"
+         << "  -P : Pin the simulation stages to these comma-separated CPUs, in order (with -s)\n"
+         << "  -b : Write binary verdict records to verdict_file ('-' for stdout) instead of text (with -s)\n"
+         << "  -i : Print the traffic counters to stderr every this many seconds (with -s)\n"
+         << "  -w : Reload forward_file whenever it changes during the simulation (with -s)\n"
+         << "  -v : Print simulation and pipeline statistics to stderr (with -s)\n"
+         << "  -O : Aggregate the forwarding table to its minimal equivalent form (with -r or -s)\n"
+         << "  -V : Repeated -f files are the tables of VRFs 0, 1, ...; trace records carry a VRF id (with -s)\n"
+         << "  -H : Back large lookup tables with huge pages, near the router stage's CPU with -P (with -s)\n"
+         << "  -J : Print the traffic counters as JSON lines (with -s)\n"
+         << "  -R : Look up windows of this many packets (up to 16384) sorted by destination,\n"
+         << "       once per distinct destination (with -s)\n"
+         << "  SIGUSR1 to a running -s prints the traffic counters to stderr.\n";
     exit(EXIT_FAILURE);
 }
 
+bool parseEngine(const string &name, ForwardingTable::LookupEngine &engine)
+{
+    if (name == "hash")
+        engine = ForwardingTable::LookupEngine::Hash;
+    else if (name == "bloom")
+        engine = ForwardingTable::LookupEngine::Bloom;
+    else if (name == "bsl")
+        engine = ForwardingTable::LookupEngine::LengthSearch;
+    else if (name == "spec")
+        engine = ForwardingTable::LookupEngine::Specialized;
+    else
+        return false;
+    return true;
+}
+
+bool parseCpuList(const string &text, vector<int> &cpus)
+{
+    stringstream in(text);
+    string item;
+    while (getline(in, item, ','))
+    {
+        if (item.empty() || item.size() > 4 || item.find_first_not_of("0123456789") != string::npos)
+            return false;
+        cpus.push_back(stoi(item));
+    }
+    return !cpus.empty() && text.back() != ',';
+}
+
+bool parseSeconds(const string &text, unsigned &seconds)
+{
+    if (text.empty() || text.size() > 6 || text.find_first_not_of("0123456789") != string::npos)
+        return false;
+    seconds = static_cast<unsigned>(stoul(text));
+    return seconds > 0;
+}
+
+bool parseWindow(const string &text, size_t &window)
+{
+    if (text.empty() || text.size() > 5 || text.find_first_not_of("0123456789") != string::npos)
+        return false;
+    window = stoul(text);
+    return window > 0 && window <= MAX_REORDER_WINDOW;
+}
+
 void parseArgs(int argc, char *argv[], CliArgs &args)
 {
     int opt;
-    while ((opt = getopt(argc, argv, "prs f:t:")) != -1)
+    while ((opt = getopt(argc, argv, "prscd f:t:a:g:q:e:P:b:i:wvOVHJR:")) != -1)
     {
         switch (opt)
         {
@@ -60,27 +213,102 @@ void parseArgs(int argc, char *argv[], CliArgs &args)
         case 's':
             args.sim_mode = true;
             break;
+        case 'c':
+            args.convert_mode = true;
+            break;
+        case 'd':
+            args.diff_mode = true;
+            break;
+        case 'b':
+            args.verdict_file = optarg;
+            break;
         case 'f':
             args.forward_file = optarg;
+            args.forward_files.push_back(optarg);
             break;
         case 't':
             args.trace_file = optarg;
             break;
+        case 'a':
+            args.acl_file = optarg;
+            break;
+        case 'g':
+            args.group_file = optarg;
+            break;
+        case 'q':
+            args.queue_file = optarg;
+            break;
+        case 'e':
+            if (!parseEngine(optarg, args.engine))
+            {
+                cerr << "Error: unknown lookup engine '" << optarg << "'\n";
+                usage(argv[0]);
+            }
+            break;
+        case 'P':
+            if (!parseCpuList(optarg, args.cpus))
+            {
+                cerr << "Error: invalid CPU list '" << optarg << "'\n";
+                usage(argv[0]);
+            }
+            break;
+        case 'i':
+            if (!parseSeconds(optarg, args.stats_interval))
+            {
+                cerr << "Error: invalid stats interval '" << optarg << "'\n";
+                usage(argv[0]);
+            }
+            break;
+        case 'w':
+            args.watch = true;
+            break;
+        case 'v':
+            args.verbose = true;
+            break;
+        case 'O':
+            args.aggregate = true;
+            break;
+        case 'V':
+            args.vrf = true;
+            break;
+        case 'H':
+            args.huge_pages = true;
+            break;
+        case 'J':
+            args.stats_json = true;
+            break;
+        case 'R':
+            if (!parseWindow(optarg, args.reorder_window))
+            {
+                cerr << "Error: invalid reorder window '" << optarg << "'\n";
+                usage(argv[0]);
+            }
+            break;
         default:
             usage(argv[0]);
         }
     }
 
-    int mode_count = args.packet_mode + args.table_mode + args.sim_mode;
+    int mode_count = args.packet_mode + args.table_mode + args.sim_mode + args.convert_mode + args.diff_mode;
     if (mode_count != 1)
     {
-        cerr << "Error: Specify exactly one mode (-p, -r, or -s)\n";
+        cerr << "Error: Specify exactly one mode (-p, -r, -s, -c, or -d)\n";
         usage(argv[0]);
     }
 
     if ((args.packet_mode && args.trace_file.empty()) ||
         (args.table_mode && args.forward_file.empty()) ||
-        (args.sim_mode && (args.forward_file.empty() || args.trace_file.empty())))
+        (args.sim_mode && (args.forward_file.empty() || args.trace_file.empty())) ||
+        (args.diff_mode && args.forward_files.size() != 2) ||
+        (!args.sim_mode && (!args.acl_file.empty() || !args.group_file.empty() || !args.queue_file.empty() ||
+                            args.watch || args.verbose ||
+                            args.engine != ForwardingTable::LookupEngine::Hash || !args.cpus.empty() ||
+                            args.huge_pages || args.stats_interval > 0 || args.stats_json ||
+                            args.reorder_window > 0)) ||
+        ((args.packet_mode || args.convert_mode || args.diff_mode) && args.aggregate) ||
+        (args.convert_mode && (args.verdict_file.empty() || args.verdict_file == "-")) ||
+        (!args.sim_mode && !args.convert_mode && !args.verdict_file.empty()) ||
+        (args.vrf && (!args.sim_mode || args.watch || args.engine != ForwardingTable::LookupEngine::Hash)))
     {
         usage(argv[0]);
     }
@@ -124,12 +352,40 @@ string ipToString(uint32_t ip)
 
 bool isChecksumValid(const iphdr &hdr)
 {
-    return ntohs(hdr.check) == 1234;
+    return ntohs(hdr.check) == TRACE_VALID_CHECKSUM;
+}
+
+void printPacketRecord(double timestamp, const iphdr &hdr)
+{
+    string src = ipToString(hdr.saddr);
+    string dst = ipToString(hdr.daddr);
+    bool checksum_ok = isChecksumValid(hdr);
+
+    cout << fixed << setprecision(6)
+         << timestamp << " "
+         << src << " "
+         << dst << " "
+         << (checksum_ok ? "P" : "F") << " "
+         << static_cast<int>(hdr.ttl) << "\n";
+}
+
+void printCaptureTrace(const string &capturefile)
+{
+    CaptureReader capture(capturefile);
+    TraceRecord record;
+    while (capture.read(&record, 1) == 1)
+        printPacketRecord(static_cast<double>(ntohl(record.sec)) + static_cast<double>(ntohl(record.usec)) / 1'000'000.0,
+                          record.hdr);
 }
 
 void printPacketTrace(const string &tracefile)
 {
     ifstream file = openFile(tracefile);
+    if (CaptureReader::isCapture(tracefile))
+    {
+        printCaptureTrace(tracefile);
+        return;
+    }
 
     while (true)
     {
@@ -141,24 +397,28 @@ void printPacketTrace(const string &tracefile)
         if (!readIpHeader(file, hdr))
             break;
 
-        string src = ipToString(hdr.saddr);
-        string dst = ipToString(hdr.daddr);
-        bool checksum_ok = isChecksumValid(hdr);
-
-        cout << fixed << setprecision(6)
-             << timestamp << " "
-             << src << " "
-             << dst << " "
-             << (checksum_ok ? "P" : "F") << " "
-             << static_cast<int>(hdr.ttl) << "\n";
+        printPacketRecord(timestamp, hdr);
     }
 
     file.close();
 }
 
-void printForwardingTable(const string &fname)
+ForwardingTable *loadForwardingTable(const string &fname, bool aggregate,
+                                     ForwardingTable::LookupEngine engine = ForwardingTable::LookupEngine::Hash)
 {
-    ForwardingTable ft(fname);
+    auto ft = make_unique<ForwardingTable>(fname, engine);
+    if (!aggregate)
+        return ft.release();
+
+    auto aggregated = make_unique<ForwardingTable>(aggregateRoutes(*ft));
+    cerr << "aggregated " << ft->entries().size() << " -> " << aggregated->entries().size() << " entries\n";
+    return aggregated.release();
+}
+
+void printForwardingTable(const string &fname, bool aggregate)
+{
+    unique_ptr<ForwardingTable> table(loadForwardingTable(fname, aggregate));
+    const ForwardingTable &ft = *table;
 
     for (const auto &entry : ft.entries())
     {
@@ -176,46 +436,893 @@ void printForwardingTable(const string &fname)
     }
 }
 
-string determinePacketAction(const iphdr &hdr, const ForwardingTable &ft)
+bool isDeniedByAcl(const iphdr &hdr, const AclClassifier &acl)
+{
+    // Trace records end at the IPv4 header, so ports are classified as 0.
+    AclClassifier::Key key{ntohl(hdr.saddr), ntohl(hdr.daddr), hdr.protocol, 0, 0};
+    return !acl.permits(key);
+}
+
+int selectGroupMember(const iphdr &hdr, int group_id, SimContext &ctx)
+{
+    const NextHopGroup &group = ctx.groups->group(group_id);
+    uint32_t hash = FlowHash::hash(ntohl(hdr.saddr), ntohl(hdr.daddr), hdr.protocol, 0, 0);
+    int member = group.select(hash);
+    if (member < 0)
+        return -1;
+
+    ++ctx.member_packets[ctx.groups->groupIndex(group_id)][member];
+    return group.members()[member].iface;
+}
+
+// Drops that need no route lookup; PacketAction::Route if the packet
+// should be routed.
+PacketVerdict screenPacket(const iphdr &hdr, const SimContext &ctx)
 {
     if (!isChecksumValid(hdr))
-        return "drop checksum";
+        return {PacketAction::DropChecksum, 0};
     if (hdr.ttl == 1)
-        return "drop expired";
+        return {PacketAction::DropExpired, 0};
+    if (ctx.acl && isDeniedByAcl(hdr, *ctx.acl))
+        return {PacketAction::DropPolicy, 0};
+    return {PacketAction::Route, 0};
+}
 
-    bool is_default = false;
-    int iface = ft.lookup(ntohl(hdr.daddr), is_default);
+int lookupRoute(uint32_t dest, uint32_t vrf, const SimContext &ctx, bool &is_default)
+{
+    return ctx.vrfs ? ctx.vrfs->lookup(vrf, dest, is_default) : ctx.ft->lookup(dest, is_default);
+}
+
+// The verdict for a packet whose destination looked up to (iface,
+// is_default).
+PacketVerdict finishRoute(const iphdr &hdr, int iface, bool is_default, SimContext &ctx)
+{
+    if (ctx.groups && ctx.groups->isGroup(iface))
+    {
+        iface = selectGroupMember(hdr, iface, ctx);
+        if (iface < 0)
+            return {PacketAction::DropUnknown, 0};
+    }
 
     if (iface == 0)
-        return "drop policy";
+        return {PacketAction::DropPolicy, 0};
     if (iface > 0 && !is_default)
-        return "send " + to_string(iface);
+        return {PacketAction::Send, static_cast<uint16_t>(iface)};
     if (is_default)
-        return "default " + to_string(iface);
+        return {PacketAction::Default, static_cast<uint16_t>(iface)};
 
-    return "drop unknown";
+    return {PacketAction::DropUnknown, 0};
 }
 
-void simulatePackets(const string &forward_file, const string &trace_file)
+PacketVerdict routePacket(const iphdr &hdr, uint32_t vrf, SimContext &ctx)
 {
-    ForwardingTable ft(forward_file);
-    ifstream file = openFile(trace_file);
+    bool is_default = false;
+    int iface = lookupRoute(ntohl(hdr.daddr), vrf, ctx, is_default);
+    return finishRoute(hdr, iface, is_default, ctx);
+}
 
+void printGroupStatistics(const SimContext &ctx)
+{
+    for (size_t g = 0; g < ctx.groups->groups().size(); ++g)
+    {
+        const NextHopGroup &group = ctx.groups->groups()[g];
+        cerr << "group " << group.id() << (group.resilient() ? " resilient" : " hash-threshold") << "\n";
+        for (size_t m = 0; m < group.members().size(); ++m)
+        {
+            const auto &member = group.members()[m];
+            cerr << "  iface " << member.iface << " weight " << member.weight
+                 << (member.up ? "" : " down") << " packets " << ctx.member_packets[g][m] << "\n";
+        }
+    }
+}
+
+void printVrfStatistics(const VrfForwardingTable &vrfs)
+{
+    cerr << "vrfs " << vrfs.vrfs() << " nodes " << vrfs.nodes() << " references " << vrfs.nodeReferences()
+         << " memory " << vrfs.memoryBytes() << " bytes unshared " << vrfs.unsharedBytes() << " bytes\n";
+}
+
+void printEngineStatistics(const ForwardingTable &ft)
+{
+    if (ft.engine() == ForwardingTable::LookupEngine::LengthSearch)
+    {
+        const LengthSearchIndex &index = ft.lengthSearchIndex();
+        cerr << "bsl lengths " << index.lengths().size() << " markers " << index.markers()
+             << " max probes " << index.maxProbes() << "\n";
+        return;
+    }
+    if (ft.engine() != ForwardingTable::LookupEngine::Bloom)
+        return;
+
+    for (int plen : {8, 16, 24, 32})
+    {
+        const PrefixBloomFilter &bloom = ft.bloomFilter(plen);
+        cerr << "bloom /" << plen << " prefixes " << bloom.prefixes() << " bits " << bloom.bits()
+             << " hashes " << PrefixBloomFilter::HASHES << " fill " << fixed << setprecision(4) << bloom.fillRatio()
+             << " fpr " << bloom.falsePositiveRate() << "\n";
+    }
+}
+
+/*
+ * Simulation pipeline
+ * -------------------
+ * Packets move in batches of PIPELINE_BATCH through five stages, one thread
+ * each, connected by SPSC rings:
+ *
+ *   free -> reader -> validator -> router -> formatter -> writer -> free
+ *
+ * Batches are allocated once and recycled through the free ring, so the
+ * steady state allocates nothing. The reader pulls whole batches of raw
+ * trace records with one read, verdicts are 4-byte PacketVerdicts, the
+ * formatter renders lines with packet_verdict.hpp into the batch, and the
+ * writer gathers them in a large buffer before handing them to the output
+ * stream. With -b the formatter emits VerdictRecords instead of text. Every ring is FIFO with one
+ * producer and one consumer, so output order equals trace order. The reader
+ * marks the last batch, and each stage exits after forwarding it.
+ */
+constexpr size_t PIPELINE_BATCH = 256;
+constexpr size_t PIPELINE_DEPTH = 64;
+constexpr size_t OUTPUT_BUFFER = 1 << 20;
+static_assert(MAX_REORDER_WINDOW <= PIPELINE_BATCH * PIPELINE_DEPTH,
+              "the router's -R window must leave batches in flight for the other stages");
+
+struct PacketBatch
+{
+    vector<TraceRecord> records = vector<TraceRecord>(PIPELINE_BATCH);
+    // Host-order VRF ids, all 0 unless the trace is VRF-tagged.
+    vector<uint32_t> vrfs = vector<uint32_t>(PIPELINE_BATCH);
+    vector<PacketVerdict> verdicts = vector<PacketVerdict>(PIPELINE_BATCH);
+    size_t count = 0;
+    vector<char> text = vector<char>(PIPELINE_BATCH * MAX_VERDICT_LINE);
+    size_t text_size = 0;
+    bool last = false;
+};
+
+struct Pipeline
+{
+    static constexpr int STAGES = 5;
+    inline static const char *const STAGE_NAMES[STAGES] = {"reader", "validator", "router", "formatter", "writer"};
+
+    vector<PacketBatch> batches = vector<PacketBatch>(PIPELINE_DEPTH * 2);
+    // rings[i] feeds stage i; rings[0] is the free list.
+    SpscRing<PacketBatch *> rings[STAGES] = {SpscRing<PacketBatch *>(batches.size()), SpscRing<PacketBatch *>(PIPELINE_DEPTH),
+                                             SpscRing<PacketBatch *>(PIPELINE_DEPTH), SpscRing<PacketBatch *>(PIPELINE_DEPTH),
+                                             SpscRing<PacketBatch *>(PIPELINE_DEPTH)};
+    uint64_t processed[STAGES] = {};
+
+    // Final verdicts are counted where they are decided: screened drops by
+    // the validator (shard VALIDATOR_SHARD), routed packets by the router.
+    static constexpr size_t VALIDATOR_SHARD = 0;
+    static constexpr size_t ROUTER_SHARD = 1;
+    TrafficCounters traffic{2};
+
+    // Route stage hardware counters; only filled in with make PERF=1.
+    struct LookupProfile
+    {
+        uint64_t lookups = 0;
+        bool available = false;
+        bool counted[PerfCounters::EVENTS] = {};
+        double values[PerfCounters::EVENTS] = {};
+    } profile;
+
+    Pipeline()
+    {
+        for (auto &batch : batches)
+            rings[0].push(&batch);
+    }
+
+    SpscRing<PacketBatch *> &input(int stage) { return rings[stage]; }
+    SpscRing<PacketBatch *> &output(int stage) { return rings[(stage + 1) % STAGES]; }
+};
+
+void readStage(Pipeline &pipeline, ifstream &file, bool tagged)
+{
+    vector<VrfTraceRecord> staging(tagged ? PIPELINE_BATCH : 0);
     while (true)
     {
-        double timestamp = readTimestamp(file);
-        if (timestamp < 0)
-            break;
+        PacketBatch *batch = pipeline.input(0).pop();
+        // A trailing partial record is dropped, as a failed per-field read
+        // would have done.
+        if (tagged)
+        {
+            file.read(reinterpret_cast<char *>(staging.data()), PIPELINE_BATCH * sizeof(VrfTraceRecord));
+            batch->count = static_cast<size_t>(file.gcount()) / sizeof(VrfTraceRecord);
+            for (size_t i = 0; i < batch->count; ++i)
+            {
+                batch->vrfs[i] = ntohl(staging[i].vrf);
+                batch->records[i] = staging[i].record;
+            }
+        }
+        else
+        {
+            file.read(reinterpret_cast<char *>(batch->records.data()), PIPELINE_BATCH * sizeof(TraceRecord));
+            batch->count = static_cast<size_t>(file.gcount()) / sizeof(TraceRecord);
+        }
+        batch->last = batch->count < PIPELINE_BATCH;
 
-        iphdr hdr{};
-        if (!readIpHeader(file, hdr))
+        pipeline.processed[0] += batch->count;
+        bool last = batch->last;
+        pipeline.output(0).push(batch);
+        if (last)
+            return;
+    }
+}
+
+// readStage for pcap/pcapng input: the records are filled straight from
+// the mapped capture.
+void readCaptureStage(Pipeline &pipeline, CaptureReader &capture)
+{
+    while (true)
+    {
+        PacketBatch *batch = pipeline.input(0).pop();
+        batch->count = capture.read(batch->records.data(), PIPELINE_BATCH);
+        batch->last = batch->count < PIPELINE_BATCH;
+
+        pipeline.processed[0] += batch->count;
+        bool last = batch->last;
+        pipeline.output(0).push(batch);
+        if (last)
+            return;
+    }
+}
+
+void validateStage(Pipeline &pipeline, const SimContext &ctx)
+{
+    TrafficCounters::Shard &traffic = pipeline.traffic.shard(Pipeline::VALIDATOR_SHARD);
+    while (true)
+    {
+        PacketBatch *batch = pipeline.input(1).pop();
+        for (size_t i = 0; i < batch->count; ++i)
+        {
+            const iphdr &hdr = batch->records[i].hdr;
+            batch->verdicts[i] = screenPacket(hdr, ctx);
+            if (batch->verdicts[i].action != PacketAction::Route)
+                traffic.count(batch->verdicts[i], ntohs(hdr.tot_len));
+        }
+
+        pipeline.processed[1] += batch->count;
+        bool last = batch->last;
+        pipeline.output(1).push(batch);
+        if (last)
+            return;
+    }
+}
+
+// With window > 0 the router holds batches until it has window packets,
+// routes them in destination order and looks up a destination only when
+// it differs from the one before; without it each batch goes straight
+// through.
+void routeStage(Pipeline &pipeline, SimContext &ctx, TableReloader *reloader, int reader, size_t window)
+{
+    // Opened here because the counters follow the thread that opens them.
+    PerfCounters counters;
+    uint64_t lookups = 0;
+    TrafficCounters::Shard &traffic = pipeline.traffic.shard(Pipeline::ROUTER_SHARD);
+    DestinationOrder order;
+    vector<PacketBatch *> held;
+    bool last = false;
+
+    while (!last)
+    {
+        size_t packets = 0;
+        held.clear();
+        do
+        {
+            held.push_back(pipeline.input(2).pop());
+            packets += held.back()->count;
+            last = held.back()->last;
+        } while (!last && packets < window);
+
+        if (reloader)
+            ctx.ft = reloader->acquire();
+        counters.start();
+        if (window > 0)
+        {
+            // Items name a packet by its place among the held records; only
+            // a last batch is short, so that is batch * PIPELINE_BATCH + i.
+            vector<DestinationOrder::Item> &items = order.items();
+            size_t next = 0;
+            while (next < packets)
+            {
+                size_t end = min(next + window, packets);
+                items.clear();
+                for (size_t p = next; p < end; ++p)
+                {
+                    PacketBatch *batch = held[p / PIPELINE_BATCH];
+                    size_t i = p % PIPELINE_BATCH;
+                    if (batch->verdicts[i].action == PacketAction::Route)
+                        items.push_back({ntohl(batch->records[i].hdr.daddr), static_cast<uint32_t>(p)});
+                }
+                order.sort();
+
+                int iface = 0;
+                bool is_default = false;
+                uint32_t looked_up_vrf = 0;
+                for (size_t k = 0; k < items.size(); ++k)
+                {
+                    PacketBatch *batch = held[items[k].index / PIPELINE_BATCH];
+                    size_t i = items[k].index % PIPELINE_BATCH;
+                    const iphdr &hdr = batch->records[i].hdr;
+                    uint32_t vrf = batch->vrfs[i];
+                    if (k == 0 || items[k].dest != items[k - 1].dest || vrf != looked_up_vrf)
+                    {
+                        iface = lookupRoute(items[k].dest, vrf, ctx, is_default);
+                        looked_up_vrf = vrf;
+                        if constexpr (PerfCounters::ENABLED)
+                            ++lookups;
+                    }
+                    batch->verdicts[i] = finishRoute(hdr, iface, is_default, ctx);
+                    traffic.count(batch->verdicts[i], ntohs(hdr.tot_len));
+                }
+                next = end;
+            }
+        }
+        else
+        {
+            PacketBatch *batch = held.front();
+            for (size_t i = 0; i < batch->count; ++i)
+                if (batch->verdicts[i].action == PacketAction::Route)
+                {
+                    const iphdr &hdr = batch->records[i].hdr;
+                    batch->verdicts[i] = routePacket(hdr, batch->vrfs[i], ctx);
+                    traffic.count(batch->verdicts[i], ntohs(hdr.tot_len));
+                    if constexpr (PerfCounters::ENABLED)
+                        ++lookups;
+                }
+        }
+        counters.stop();
+        if (reloader)
+            reloader->quiescent(reader);
+
+        pipeline.processed[2] += packets;
+        for (PacketBatch *batch : held)
+            pipeline.output(2).push(batch);
+    }
+
+    if (reloader)
+        reloader->unregisterReader(reader);
+
+    if constexpr (PerfCounters::ENABLED)
+    {
+        Pipeline::LookupProfile &profile = pipeline.profile;
+        profile.lookups = lookups;
+        profile.available = counters.available();
+        for (int e = 0; e < PerfCounters::EVENTS; ++e)
+        {
+            auto event = static_cast<PerfCounters::Event>(e);
+            profile.counted[e] = counters.has(event);
+            profile.values[e] = counters.value(event);
+        }
+    }
+}
+
+void formatStage(Pipeline &pipeline, bool binary, EgressSimulator *egress)
+{
+    static_assert(sizeof(VerdictRecord) <= MAX_VERDICT_LINE, "batch text buffer too small for binary records");
+    while (true)
+    {
+        PacketBatch *batch = pipeline.input(3).pop();
+        char *out = batch->text.data();
+        for (size_t i = 0; i < batch->count; ++i)
+        {
+            const TraceRecord &record = batch->records[i];
+            PacketAction action = batch->verdicts[i].action;
+            if (egress && (action == PacketAction::Send || action == PacketAction::Default))
+                egress->arrive(batch->verdicts[i].iface, uint64_t{ntohl(record.sec)} * 1'000'000 + ntohl(record.usec),
+                               ntohs(record.hdr.tot_len));
+            if (binary)
+            {
+                VerdictRecord verdict = makeVerdictRecord(ntohl(record.sec), ntohl(record.usec), batch->verdicts[i]);
+                memcpy(out, &verdict, sizeof(verdict));
+                out += sizeof(verdict);
+            }
+            else
+            {
+                out = formatVerdictLine(out, ntohl(record.sec), ntohl(record.usec), batch->verdicts[i]);
+            }
+        }
+        batch->text_size = static_cast<size_t>(out - batch->text.data());
+
+        pipeline.processed[3] += batch->count;
+        bool last = batch->last;
+        pipeline.output(3).push(batch);
+        if (last)
+            return;
+    }
+}
+
+void writeStage(Pipeline &pipeline, ostream &output)
+{
+    vector<char> buffer(OUTPUT_BUFFER);
+    size_t used = 0;
+    auto flush = [&]()
+    {
+        output.write(buffer.data(), static_cast<streamsize>(used));
+        used = 0;
+    };
+
+    while (true)
+    {
+        PacketBatch *batch = pipeline.input(4).pop();
+        if (used + batch->text_size > buffer.size())
+            flush();
+        memcpy(buffer.data() + used, batch->text.data(), batch->text_size);
+        used += batch->text_size;
+
+        pipeline.processed[4] += batch->count;
+        // The free ring is only read by the reader, which has stopped after
+        // the last batch, so the last batch is not returned.
+        if (batch->last)
             break;
+        pipeline.output(4).push(batch);
+    }
+    flush();
+}
+
+void writeVerdictHeader(ostream &output, uint64_t records)
+{
+    VerdictFileHeader header = makeVerdictHeader(records);
+    output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+}
 
-        string action = determinePacketAction(hdr, ft);
-        cout << fixed << setprecision(6) << timestamp << " " << action << "\n";
+void pinThread(thread &worker, int cpu, const char *stage)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (pthread_setaffinity_np(worker.native_handle(), sizeof(set), &set) != 0)
+        cerr << "Warning: cannot pin " << stage << " stage to CPU " << cpu << "\n";
+}
+
+void printPipelineStatistics(Pipeline &pipeline)
+{
+    // A stage is starved when its input ring is empty (for the reader: no
+    // free batch) and blocked when its output ring is full. The bottleneck is
+    // the stage whose input queue is fullest while its output rarely blocks.
+    cerr << "stage      packets    in_mean  in_max  starved  blocked\n";
+    for (int stage = 0; stage < Pipeline::STAGES; ++stage)
+    {
+        SpscRing<PacketBatch *> &in = pipeline.input(stage);
+        cerr << left << setw(10) << Pipeline::STAGE_NAMES[stage] << right
+             << setw(8) << pipeline.processed[stage]
+             << setw(11) << fixed << setprecision(2) << in.meanOccupancy()
+             << setw(8) << in.maxOccupancy()
+             << setw(9) << in.popStalls()
+             << setw(9) << pipeline.output(stage).pushStalls() << "\n";
     }
+}
+
+void printLookupProfile(const Pipeline::LookupProfile &profile)
+{
+    if (!profile.available)
+    {
+        cerr << "lookup counters unavailable (perf_event_open failed)\n";
+        return;
+    }
+
+    // Counted over the route stage's lookup loops only, in user mode.
+    double millions = max<double>(static_cast<double>(profile.lookups), 1.0) / 1e6;
+    cerr << "lookup counters for " << profile.lookups << " lookups, per million packets:\n";
+    for (int e = 0; e < PerfCounters::EVENTS; ++e)
+    {
+        cerr << "  " << left << setw(13) << PerfCounters::EVENT_NAMES[e] << right;
+        if (profile.counted[e])
+            cerr << fixed << setprecision(0) << profile.values[e] / millions << "\n";
+        else
+            cerr << "unavailable\n";
+    }
+    if (profile.counted[PerfCounters::Cycles] && profile.counted[PerfCounters::Instructions] &&
+        profile.values[PerfCounters::Cycles] > 0)
+        cerr << "  " << left << setw(13) << "ipc" << right << fixed << setprecision(2)
+             << profile.values[PerfCounters::Instructions] / profile.values[PerfCounters::Cycles] << "\n";
+}
+
+void printEgressStatistics(EgressSimulator &egress)
+{
+    egress.finish();
+    cerr << "iface  rate_Mbps   arrivals       sent  tail_drop   red_drop  max_backlog"
+         << "   p50_us   p90_us   p99_us p99.9_us   max_us\n";
+    for (const auto &q : egress.statistics())
+    {
+        const DelayHistogram &d = *q.delays;
+        cerr << left << setw(5) << q.iface << right << fixed << setprecision(1)
+             << setw(11) << q.rate_bps / 1e6 << setw(11) << q.arrivals << setw(11) << q.sent
+             << setw(11) << q.tail_drops << setw(11) << q.red_drops << setw(13) << q.max_backlog
+             << setw(9) << d.percentile(0.50) << setw(9) << d.percentile(0.90) << setw(9) << d.percentile(0.99)
+             << setw(9) << d.percentile(0.999) << setw(9) << d.max() << "\n";
+    }
+    if (egress.lateArrivals() > 0)
+        cerr << "egress: " << egress.lateArrivals() << " packets arrived before earlier ones and were queued late\n";
+}
+
+string formatTrafficCounters(const TrafficCounters::Snapshot &snap, double elapsed, bool json)
+{
+    static constexpr PacketAction ACTIONS[] = {PacketAction::Send, PacketAction::Default, PacketAction::DropChecksum,
+                                               PacketAction::DropExpired, PacketAction::DropPolicy,
+                                               PacketAction::DropUnknown};
+    TrafficCounters::Totals total = snap.total();
+    ostringstream out;
+    out << fixed << setprecision(3);
+    if (json)
+    {
+        auto pair = [&out](const TrafficCounters::Totals &t)
+        { out << "{\"packets\":" << t.packets << ",\"bytes\":" << t.bytes << "}"; };
+        out << "{\"elapsed_s\":" << elapsed << ",\"packets\":" << total.packets << ",\"bytes\":" << total.bytes
+            << ",\"actions\":{";
+        for (PacketAction action : ACTIONS)
+        {
+            out << (action == ACTIONS[0] ? "" : ",") << "\"" << actionName(action) << "\":";
+            pair(snap.actions[static_cast<size_t>(action)]);
+        }
+        out << "},\"ifaces\":{";
+        for (size_t i = 0; i < snap.ifaces.size(); ++i)
+        {
+            out << (i == 0 ? "" : ",") << "\"" << snap.ifaces[i].first << "\":";
+            pair(snap.ifaces[i].second);
+        }
+        out << "}}\n";
+        return out.str();
+    }
+
+    out << "traffic at " << elapsed << " s: " << total.packets << " packets " << total.bytes << " bytes\n"
+        << "  verdict              packets           bytes\n";
+    for (PacketAction action : ACTIONS)
+    {
+        const TrafficCounters::Totals &t = snap.actions[static_cast<size_t>(action)];
+        out << "  " << left << setw(15) << actionName(action) << right << setw(13) << t.packets << setw(16) << t.bytes
+            << "\n";
+    }
+    for (const auto &[iface, t] : snap.ifaces)
+        out << "  iface " << left << setw(9) << iface << right << setw(13) << t.packets << setw(16) << t.bytes << "\n";
+    return out.str();
+}
+
+// Prints the traffic counters on every SIGUSR1 and, with an interval,
+// every interval seconds, until done is set and the thread is sent a
+// SIGUSR1 to wake it. SIGUSR1 must be blocked in every thread so that it
+// is only ever consumed here.
+void statsStage(const TrafficCounters &traffic, unsigned interval, bool json, const atomic<bool> &done)
+{
+    using clock = chrono::steady_clock;
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGUSR1);
+
+    clock::time_point start = clock::now();
+    clock::time_point next = start + chrono::seconds(interval);
+    while (true)
+    {
+        int sig;
+        if (interval > 0)
+        {
+            auto wait = max(chrono::duration_cast<chrono::nanoseconds>(next - clock::now()), chrono::nanoseconds(0));
+            timespec timeout{static_cast<time_t>(wait.count() / 1'000'000'000), static_cast<long>(wait.count() % 1'000'000'000)};
+            sig = sigtimedwait(&set, nullptr, &timeout);
+        }
+        else
+        {
+            sig = sigwaitinfo(&set, nullptr);
+        }
+        if (done.load(memory_order_acquire))
+            return;
+
+        clock::time_point now = clock::now();
+        bool due = interval > 0 && now >= next;
+        if (sig != SIGUSR1 && !due)
+            continue;
+        while (due && next <= now)
+            next += chrono::seconds(interval);
+
+        string dump = formatTrafficCounters(traffic.snapshot(), chrono::duration<double>(now - start).count(), json);
+        cerr.write(dump.data(), static_cast<streamsize>(dump.size()));
+        cerr.flush();
+    }
+}
+
+void printPageBacking()
+{
+    HugePages::Usage usage = HugePages::usage();
+    cerr << "table pages:";
+    for (PageBacking backing : {PageBacking::Explicit, PageBacking::Transparent, PageBacking::Small})
+    {
+        int b = static_cast<int>(backing);
+        cerr << " " << pageBackingName(backing) << " " << usage.bytes[b] / 1024 << " KiB in " << usage.regions[b]
+             << (usage.regions[b] == 1 ? " region," : " regions,");
+    }
+    cerr << " thp-resident " << HugePages::transparentResidentBytes() / 1024 << " KiB";
+    if (HugePages::numaNode() >= 0)
+        cerr << ", numa node " << HugePages::numaNode();
+    cerr << " (tables under " << HugePages::MIN_BYTES / 1024 << " KiB stay on the heap)\n";
+}
+
+void simulatePackets(const CliArgs &args)
+{
+    // Blocked before any thread starts, so every thread inherits the mask
+    // and SIGUSR1 is left for statsStage to take with sigwait.
+    sigset_t usr1;
+    sigemptyset(&usr1);
+    sigaddset(&usr1, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &usr1, nullptr);
+
+    // Pages are placed at first touch, i.e. while the tables are built, so
+    // the policy is set before anything is loaded.
+    if (args.huge_pages)
+        HugePages::configure(true, args.cpus.size() > 2 ? HugePages::cpuNode(args.cpus[2]) : -1);
+
+    unique_ptr<ForwardingTable> ft;
+    unique_ptr<VrfForwardingTable> vrfs;
+    unique_ptr<TableReloader> reloader;
+    if (args.vrf)
+    {
+        // Each table is only needed until its nodes are interned, so it is
+        // freed before the next one is loaded.
+        vrfs = make_unique<VrfForwardingTable>();
+        for (const auto &fname : args.forward_files)
+        {
+            unique_ptr<ForwardingTable> table(loadForwardingTable(fname, args.aggregate));
+            vrfs->addVrf(*table);
+        }
+    }
+    else if (args.watch)
+        reloader = make_unique<TableReloader>(args.forward_file, [&args](const string &fname)
+                                              { return loadForwardingTable(fname, args.aggregate, args.engine); });
+    else
+        ft.reset(loadForwardingTable(args.forward_file, args.aggregate, args.engine));
+    int reader = reloader ? reloader->registerReader() : -1;
+
+    unique_ptr<AclClassifier> acl;
+    if (!args.acl_file.empty())
+        acl = make_unique<AclClassifier>(args.acl_file);
+    unique_ptr<NextHopGroupTable> groups;
+    if (!args.group_file.empty())
+        groups = make_unique<NextHopGroupTable>(args.group_file);
+
+    SimContext ctx;
+    ctx.ft = ft.get();
+    ctx.vrfs = vrfs.get();
+    ctx.acl = acl.get();
+    ctx.groups = groups.get();
+    if (groups)
+        for (const auto &group : groups->groups())
+            ctx.member_packets.emplace_back(group.members().size(), 0);
+
+    unique_ptr<QueueConfigTable> queues;
+    unique_ptr<EgressSimulator> egress;
+    if (!args.queue_file.empty())
+    {
+        queues = make_unique<QueueConfigTable>(args.queue_file);
+        egress = make_unique<EgressSimulator>(*queues);
+    }
+
+    ifstream file = openFile(args.trace_file);
+    unique_ptr<CaptureReader> capture;
+    if (CaptureReader::isCapture(args.trace_file))
+    {
+        if (args.vrf)
+        {
+            cerr << "Error: -V needs a VRF-tagged trace, not a packet capture\n";
+            exit(EXIT_FAILURE);
+        }
+        capture = make_unique<CaptureReader>(args.trace_file);
+    }
+
+    bool binary = !args.verdict_file.empty();
+    ofstream verdict_out;
+    if (binary && args.verdict_file != "-")
+    {
+        verdict_out.open(args.verdict_file, ios::binary | ios::trunc);
+        if (!verdict_out.is_open())
+        {
+            cerr << "Error: Cannot open file '" << args.verdict_file << "'\n";
+            exit(EXIT_FAILURE);
+        }
+    }
+    ostream &output = verdict_out.is_open() ? static_cast<ostream &>(verdict_out) : cout;
+    if (binary)
+        writeVerdictHeader(output, 0);
+
+    auto pipeline = make_unique<Pipeline>();
+    auto started = chrono::steady_clock::now();
+    atomic<bool> stats_done{false};
+    thread stats(statsStage, cref(pipeline->traffic), args.stats_interval, args.stats_json, cref(stats_done));
+    thread workers[Pipeline::STAGES] = {
+        capture ? thread(readCaptureStage, ref(*pipeline), ref(*capture))
+                : thread(readStage, ref(*pipeline), ref(file), args.vrf),
+        thread(validateStage, ref(*pipeline), cref(ctx)),
+        thread(routeStage, ref(*pipeline), ref(ctx), reloader.get(), reader, args.reorder_window),
+        thread(formatStage, ref(*pipeline), binary, egress.get()),
+        thread(writeStage, ref(*pipeline), ref(output))};
+    for (size_t stage = 0; stage < args.cpus.size() && stage < Pipeline::STAGES; ++stage)
+        pinThread(workers[stage], args.cpus[stage], Pipeline::STAGE_NAMES[stage]);
+    for (auto &worker : workers)
+        worker.join();
+    stats_done.store(true, memory_order_release);
+    pthread_kill(stats.native_handle(), SIGUSR1);
+    stats.join();
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    // The router has left its reader slot: stop reloading before the
+    // current table and the reload counts are printed.
+    if (reloader)
+        reloader->stop();
 
     file.close();
+
+    if (verdict_out.is_open())
+    {
+        // Record the count now that it is known; writing to stdout leaves 0.
+        verdict_out.seekp(0);
+        writeVerdictHeader(verdict_out, pipeline->processed[Pipeline::STAGES - 1]);
+        verdict_out.close();
+    }
+
+    if (args.verbose || args.stats_interval > 0 || args.stats_json)
+        cerr << formatTrafficCounters(pipeline->traffic.snapshot(), elapsed, args.stats_json);
+    if (args.verbose)
+        printPipelineStatistics(*pipeline);
+    if (args.verbose && capture)
+        cerr << "capture " << capture->formatName() << " packets " << capture->packets() << " skipped "
+             << capture->skipped() << " (not IPv4 or truncated)\n";
+    if (args.verbose && vrfs)
+        printVrfStatistics(*vrfs);
+    else if (args.verbose)
+        printEngineStatistics(reloader ? *reloader->acquire() : *ft);
+    if (args.verbose && groups)
+        printGroupStatistics(ctx);
+    if constexpr (PerfCounters::ENABLED)
+        printLookupProfile(pipeline->profile);
+    if (egress)
+        printEgressStatistics(*egress);
+    if (args.huge_pages)
+        printPageBacking();
+    if (args.verbose && reloader)
+        cerr << "table reloads " << reloader->reloads() << " failed " << reloader->failedReloads() << "\n";
+}
+
+void convertVerdicts(const string &fname)
+{
+    VerdictFileReader verdicts(fname);
+
+    vector<char> buffer(OUTPUT_BUFFER);
+    size_t used = 0;
+    for (uint64_t i = 0; i < verdicts.size(); ++i)
+    {
+        VerdictRecord record = verdicts.record(i);
+        if (record.action <= static_cast<uint8_t>(PacketAction::Route) ||
+            record.action > static_cast<uint8_t>(PacketAction::DropUnknown))
+            throw runtime_error("Error: invalid action code " + to_string(record.action) +
+                                " in verdict record " + to_string(i));
+
+        if (used + MAX_VERDICT_LINE > buffer.size())
+        {
+            cout.write(buffer.data(), static_cast<streamsize>(used));
+            used = 0;
+        }
+        PacketVerdict verdict{static_cast<PacketAction>(record.action), record.iface};
+        used = static_cast<size_t>(formatVerdictLine(buffer.data() + used, record.sec, record.usec, verdict) - buffer.data());
+    }
+    cout.write(buffer.data(), static_cast<streamsize>(used));
+}
+
+char *appendAddress(char *out, uint32_t ip)
+{
+    for (int shift = 24; shift >= 0; shift -= 8)
+    {
+        out = verdict_detail::appendUnsigned(out, (ip >> shift) & 0xFF);
+        *out++ = shift == 0 ? ' ' : '.';
+    }
+    return out;
+}
+
+// "N", "default N" or "none", as lookup() would decide.
+char *appendRoute(char *out, const RouteRange &route)
+{
+    if (route.iface < 0)
+        return verdict_detail::appendText(out, "none", 4);
+    if (route.is_default)
+        out = verdict_detail::appendText(out, "default ", 8);
+    return verdict_detail::appendUnsigned(out, static_cast<uint64_t>(route.iface));
+}
+
+/*
+ * Counts, per changed range, the trace packets that would be routed (valid
+ * checksum, TTL above 1) to a destination inside it. The trace may be a
+ * pcap or pcapng capture, read as simulatePackets reads it.
+ */
+vector<uint64_t> countAffectedPackets(const string &tracefile, const vector<RouteChange> &changes,
+                                      uint64_t &routed)
+{
+    constexpr size_t CHUNK = 1 << 14;
+
+    ifstream file = openFile(tracefile);
+    unique_ptr<CaptureReader> capture;
+    if (CaptureReader::isCapture(tracefile))
+        capture = make_unique<CaptureReader>(tracefile);
+
+    vector<TraceRecord> records(CHUNK);
+    vector<uint64_t> counts(changes.size(), 0);
+    SimContext ctx;
+    routed = 0;
+    while (true)
+    {
+        size_t count;
+        if (capture)
+            count = capture->read(records.data(), CHUNK);
+        else
+        {
+            file.read(reinterpret_cast<char *>(records.data()), CHUNK * sizeof(TraceRecord));
+            count = static_cast<size_t>(file.gcount()) / sizeof(TraceRecord);
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (screenPacket(records[i].hdr, ctx).action != PacketAction::Route)
+                continue;
+            ++routed;
+            uint32_t dest = ntohl(records[i].hdr.daddr);
+            auto it = upper_bound(changes.begin(), changes.end(), dest, [](uint32_t ip, const RouteChange &c)
+                                  { return ip < c.first; });
+            if (it != changes.begin() && prev(it)->last >= dest)
+                ++counts[static_cast<size_t>(prev(it) - changes.begin())];
+        }
+        if (count < CHUNK)
+            return counts;
+    }
+}
+
+/*
+ * Diff mode: both tables are flattened into their route ranges and merged
+ * (route_ranges.hpp), giving the minimal list of ranges that change route.
+ * Each line is "<first> <last> <old> -> <new>", plus the number of affected
+ * trace packets with -t, followed by a summary line.
+ */
+void diffForwardingTables(const CliArgs &args)
+{
+    vector<RouteChange> changes;
+    {
+        ForwardingTable before(args.forward_files[0]);
+        ForwardingTable after(args.forward_files[1]);
+        changes = diffRanges(expandToRanges(before), expandToRanges(after));
+    }
+
+    uint64_t routed = 0;
+    vector<uint64_t> packets;
+    if (!args.trace_file.empty())
+        packets = countAffectedPackets(args.trace_file, changes, routed);
+
+    constexpr size_t MAX_LINE = 96;
+    vector<char> buffer(OUTPUT_BUFFER);
+    size_t used = 0;
+    uint64_t addresses = 0, affected = 0;
+    for (size_t i = 0; i < changes.size(); ++i)
+    {
+        const RouteChange &change = changes[i];
+        addresses += change.last - static_cast<uint64_t>(change.first) + 1;
+
+        if (used + MAX_LINE > buffer.size())
+        {
+            cout.write(buffer.data(), static_cast<streamsize>(used));
+            used = 0;
+        }
+        char *out = buffer.data() + used;
+        out = appendAddress(out, change.first);
+        out = appendAddress(out, change.last);
+        out = appendRoute(out, change.before);
+        out = verdict_detail::appendText(out, " -> ", 4);
+        out = appendRoute(out, change.after);
+        if (!packets.empty())
+        {
+            affected += packets[i];
+            out = verdict_detail::appendText(out, " packets ", 9);
+            out = verdict_detail::appendUnsigned(out, packets[i]);
+        }
+        *out++ = '\n';
+        used = static_cast<size_t>(out - buffer.data());
+    }
+    cout.write(buffer.data(), static_cast<streamsize>(used));
+
+    cout << "changed ranges " << changes.size() << " addresses " << addresses;
+    if (!args.trace_file.empty())
+        cout << " packets " << affected << " of " << routed << " routed";
+    cout << "\n";
 }
 
 int main(int argc, char *argv[])
@@ -229,11 +1336,19 @@ int main(int argc, char *argv[])
     }
     else if (args.table_mode)
     {
-        printForwardingTable(args.forward_file);
+        printForwardingTable(args.forward_file, args.aggregate);
     }
     else if (args.sim_mode)
     {
-        simulatePackets(args.forward_file, args.trace_file);
+        simulatePackets(args);
+    }
+    else if (args.convert_mode)
+    {
+        convertVerdicts(args.verdict_file);
+    }
+    else if (args.diff_mode)
+    {
+        diffForwardingTables(args);
     }
 
     return 0;
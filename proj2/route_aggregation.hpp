@@ -0,0 +1,269 @@
+#ifndef ROUTE_AGGREGATION_HPP
+#define ROUTE_AGGREGATION_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "forwarding_table.hpp"
+#include "route_ranges.hpp"
+
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: route_aggregation.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  This class computes the smallest set of forwarding entries that routes
+ *  every address exactly like a loaded ForwardingTable, using the Optimal
+ *  Routing Table Constructor (ORTC, Draves et al.) adapted to the /8, /16,
+ *  /24 and /32 prefix lengths ForwardingTable supports.
+ *
+ * =============================================================================
+ *  Class: RouteAggregator
+ *  ---------------------------------------------------------------------------
+ *  Binary ORTC works on a trie with one bit per level. Here every level
+ *  consumes 8 bits, so each node has up to 256 children; children that do
+ *  not exist simply carry the label their parent would push down to them.
+ *
+ *    Pass 1+2 (bottom-up, computeSets):
+ *      Each node's effective label is its own iface or the one it inherits.
+ *      A leaf's candidate set is {its label}. An inner node counts, over all
+ *      256 child slots, how many child candidate sets contain each label
+ *      (absent slots contribute the node's own label) and keeps the labels
+ *      with the highest count. As in binary ORTC, a child costs one extra
+ *      entry exactly when the label it inherits is outside its set, so the
+ *      most frequent labels are the optimal choices for the parent.
+ *
+ *    Pass 3 (top-down, assign):
+ *      A node keeps the inherited label when it is in its candidate set;
+ *      otherwise it takes any candidate and emits an entry. Absent child
+ *      slots whose original label differs from the chosen one get their
+ *      own entry one level down.
+ *
+ *  ---------------------------------------------------------------------------
+ *  ForwardingTable specifics:
+ *  - Addresses outside every prefix have the "background" label (the
+ *    default route, or no route). It cannot be written as an entry, so a
+ *    node with background anywhere below it must not emit an entry; such
+ *    nodes are forced to the background label.
+ *  - An entry with address 0.0.0.0 is what defines the default route. If
+ *    the table has one, the 0.0.0.0/8 node is pinned and re-emitted
+ *    as the loader would have built it. Any other emitted prefix whose network address is 0 is
+ *    written with a host bit set (0.0.0.1) so the loader keeps it an
+ *    ordinary route.
+ *  - aggregateRoutes() builds the reduced table and checks it against the
+ *    original with verifyEquivalent() before handing it out.
+ * =============================================================================
+ */
+class RouteAggregator
+{
+public:
+    explicit RouteAggregator(const ForwardingTable &ft)
+        : has_default_(ft.hasDefault()), default_iface_(ft.getDefault())
+    {
+        nodes_.push_back({0, 0, NO_LABEL, {}, {}, BACKGROUND, false});
+        for (const auto &p : effectivePrefixes(ft))
+            insert(p);
+        for (auto &node : nodes_)
+            std::sort(node.children.begin(), node.children.end());
+
+        computeSets(0, BACKGROUND);
+        assign(0, BACKGROUND);
+        placeSplitDefault();
+    }
+
+    const std::vector<ForwardingTable::Entry> &entries() const noexcept { return result_; }
+
+private:
+    static constexpr int NO_LABEL = -1;
+    static constexpr int BACKGROUND = -2;
+    static constexpr size_t NO_SPLIT = SIZE_MAX;
+
+    struct Node
+    {
+        uint32_t addr;
+        uint16_t prefix_len;
+        int label;
+        std::vector<std::pair<uint8_t, uint32_t>> children;
+        std::vector<int> candidates;
+        int effective;
+        bool needs_background;
+    };
+
+    bool has_default_;
+    int default_iface_;
+    size_t split_default_ = NO_SPLIT;
+    std::vector<Node> nodes_;
+    std::unordered_map<uint64_t, uint32_t> index_;
+    std::vector<ForwardingTable::Entry> result_;
+
+    static uint32_t childAddress(const Node &node, uint8_t slot)
+    {
+        return node.addr | (static_cast<uint32_t>(slot) << (24 - node.prefix_len));
+    }
+
+    void insert(const ForwardingTable::Entry &p)
+    {
+        uint32_t current = 0;
+        for (uint16_t len = 8; len <= p.prefix_len; len += 8)
+        {
+            uint32_t addr = p.addr & (0xFFFFFFFF << (32 - len));
+            uint64_t key = (static_cast<uint64_t>(len) << 32) | addr;
+            auto it = index_.find(key);
+            if (it == index_.end())
+            {
+                uint32_t child = static_cast<uint32_t>(nodes_.size());
+                nodes_.push_back({addr, len, NO_LABEL, {}, {}, BACKGROUND, false});
+                nodes_[current].children.emplace_back(static_cast<uint8_t>(addr >> (32 - len)), child);
+                it = index_.emplace(key, child).first;
+            }
+            current = it->second;
+        }
+        nodes_[current].label = p.iface;
+    }
+
+    void computeSets(uint32_t n, int inherited)
+    {
+        Node &node = nodes_[n];
+        node.effective = node.label != NO_LABEL ? node.label : inherited;
+
+        if (node.children.empty())
+        {
+            node.candidates = {node.effective};
+            node.needs_background = node.effective == BACKGROUND;
+            return;
+        }
+
+        std::vector<std::pair<int, uint32_t>> counts;
+        auto count = [&](int label, uint32_t times)
+        {
+            for (auto &c : counts)
+                if (c.first == label)
+                {
+                    c.second += times;
+                    return;
+                }
+            counts.emplace_back(label, times);
+        };
+
+        size_t absent = 256 - node.children.size();
+        node.needs_background = absent > 0 && node.effective == BACKGROUND;
+        if (absent > 0)
+            count(node.effective, static_cast<uint32_t>(absent));
+
+        for (const auto &[slot, child] : node.children)
+        {
+            computeSets(child, nodes_[n].effective);
+            for (int label : nodes_[child].candidates)
+                count(label, 1);
+            nodes_[n].needs_background |= nodes_[child].needs_background;
+        }
+
+        Node &self = nodes_[n];
+        if (self.needs_background)
+        {
+            self.candidates = {BACKGROUND};
+            return;
+        }
+
+        uint32_t best = 0;
+        for (const auto &c : counts)
+            best = std::max(best, c.second);
+        for (const auto &c : counts)
+            if (c.second == best)
+                self.candidates.push_back(c.first);
+    }
+
+    void assign(uint32_t n, int inherited)
+    {
+        const Node &node = nodes_[n];
+        int chosen = inherited;
+
+        bool pinned = has_default_ && node.prefix_len == 8 && node.addr == 0;
+        if (pinned)
+        {
+            chosen = node.effective;
+            emitDefault(chosen);
+        }
+        else if (node.prefix_len > 0 &&
+                 std::find(node.candidates.begin(), node.candidates.end(), inherited) == node.candidates.end())
+        {
+            chosen = node.candidates.front();
+            emit(node.addr, node.prefix_len, chosen);
+        }
+
+        if (node.prefix_len == 32)
+            return;
+
+        size_t next = 0;
+        for (int slot = 0; slot < 256; ++slot)
+        {
+            if (next < node.children.size() && node.children[next].first == slot)
+            {
+                assign(node.children[next++].second, chosen);
+            }
+            else if (node.effective != chosen && !node.children.empty())
+            {
+                emit(childAddress(node, static_cast<uint8_t>(slot)),
+                     static_cast<uint16_t>(node.prefix_len + 8), node.effective);
+            }
+        }
+    }
+
+    /*
+     * The loader stores an address-0 entry both as the default route and as
+     * 0.0.0.0/8. A later 0.0.0.x/8 entry may have replaced the /8 part; that
+     * split is reproduced by a default entry with a longer prefix length
+     * (forced back to /8, but with its own duplicate key) followed by a
+     * host-bit /8 entry. The length is picked once all other entries are
+     * known, so the duplicate keys cannot collide.
+     */
+    void emitDefault(int label)
+    {
+        if (label != default_iface_)
+            split_default_ = result_.size();
+        result_.push_back({0, 8, static_cast<uint16_t>(default_iface_)});
+        if (label != default_iface_)
+            result_.push_back({1, 8, static_cast<uint16_t>(label)});
+    }
+
+    void placeSplitDefault()
+    {
+        if (split_default_ == NO_SPLIT)
+            return;
+        for (uint16_t len : {16, 24, 32})
+        {
+            bool used = std::any_of(result_.begin(), result_.end(), [&](const ForwardingTable::Entry &e)
+                                    { return e.prefix_len == len && (e.addr >> (32 - len)) == 0; });
+            if (!used)
+            {
+                result_[split_default_].prefix_len = len;
+                return;
+            }
+        }
+    }
+
+    void emit(uint32_t addr, uint16_t prefix_len, int label)
+    {
+        // 0.0.0.0 would turn the entry into the default route when loaded.
+        result_.push_back({addr == 0 ? 1u : addr, prefix_len, static_cast<uint16_t>(label)});
+    }
+};
+
+inline ForwardingTable aggregateRoutes(const ForwardingTable &ft)
+{
+    ForwardingTable aggregated(RouteAggregator(ft).entries(), ft.engine());
+
+    uint32_t ip = 0;
+    if (!verifyEquivalent(ft, aggregated, ip))
+        throw std::runtime_error("Error: aggregated forwarding table differs at " +
+                                 std::to_string(ip >> 24) + "." + std::to_string((ip >> 16) & 0xFF) + "." +
+                                 std::to_string((ip >> 8) & 0xFF) + "." + std::to_string(ip & 0xFF));
+    return aggregated;
+}
+
+#endif
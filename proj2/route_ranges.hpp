@@ -0,0 +1,197 @@
+#ifndef ROUTE_RANGES_HPP
+#define ROUTE_RANGES_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+#include "forwarding_table.hpp"
+
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: route_ranges.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  Flattens a ForwardingTable into the sorted list of disjoint address
+ *  ranges it forwards identically, and uses that to check that two tables
+ *  make the same decision for every IPv4 address or to list where they
+ *  differ.
+ *
+ * =============================================================================
+ *  expandToRanges():
+ *    Prefixes are sorted by start address, shorter first, and swept with a
+ *    stack of enclosing prefixes. Each maximal run of addresses with the
+ *    same lookup() result becomes one RouteRange; addresses outside every
+ *    prefix get the default route (or "no route"). Adjacent ranges with the
+ *    same result are merged, so the list is the minimal description of the
+ *    table's forwarding behaviour. O(n log n) in the number of entries.
+ *
+ *  verifyEquivalent():
+ *    A table's lookup() is constant between two consecutive range starts of
+ *    its own expansion. Taking the union of both tables' range starts gives
+ *    intervals on which both tables are constant, so probing lookup() once
+ *    per interval on both tables checks all 2^32 addresses exactly.
+ *
+ *  diffRanges():
+ *    Both expansions cover all 2^32 addresses in order, so one merge walk
+ *    over the two lists visits every interval on which neither table
+ *    changes its decision. Intervals where the decisions differ are
+ *    emitted, and neighbours with the same (before, after) pair are joined,
+ *    giving the minimal list of changed ranges. Linear in the two lists.
+ * =============================================================================
+ */
+
+struct RouteRange
+{
+    uint32_t first;
+    uint32_t last;
+    int iface;
+    bool is_default;
+
+    bool sameRoute(const RouteRange &other) const noexcept
+    {
+        return iface == other.iface && is_default == other.is_default;
+    }
+};
+
+/*
+ * The prefixes lookup() actually searches: masked address, prefix length and
+ * iface, with later entries for the same prefix replacing earlier ones the
+ * way ForwardingTable::buildTable does.
+ */
+inline std::vector<ForwardingTable::Entry> effectivePrefixes(const ForwardingTable &ft)
+{
+    std::vector<ForwardingTable::Entry> prefixes;
+    prefixes.reserve(ft.entries().size());
+    for (const auto &e : ft.entries())
+    {
+        uint32_t mask = e.prefix_len == 0 ? 0 : 0xFFFFFFFF << (32 - e.prefix_len);
+        prefixes.push_back({e.addr & mask, e.prefix_len, e.iface});
+    }
+
+    // Stable, so the last of several equal prefixes is the one kept.
+    auto key = [](const ForwardingTable::Entry &e)
+    { return (static_cast<uint64_t>(e.addr) << 8) | e.prefix_len; };
+    std::stable_sort(prefixes.begin(), prefixes.end(), [&](const auto &a, const auto &b)
+                     { return key(a) < key(b); });
+
+    size_t kept = 0;
+    for (size_t i = 0; i < prefixes.size(); ++i)
+        if (i + 1 == prefixes.size() || key(prefixes[i]) != key(prefixes[i + 1]))
+            prefixes[kept++] = prefixes[i];
+    prefixes.resize(kept);
+    return prefixes;
+}
+
+inline std::vector<RouteRange> expandToRanges(const ForwardingTable &ft)
+{
+    const RouteRange background{0, 0, ft.hasDefault() ? ft.getDefault() : -1, ft.hasDefault()};
+
+    std::vector<RouteRange> ranges;
+    auto emit = [&](uint64_t first, uint64_t last, const RouteRange &route)
+    {
+        if (first > last)
+            return;
+        if (!ranges.empty() && ranges.back().sameRoute(route) && ranges.back().last + 1ULL == first)
+        {
+            ranges.back().last = static_cast<uint32_t>(last);
+            return;
+        }
+        ranges.push_back({static_cast<uint32_t>(first), static_cast<uint32_t>(last), route.iface, route.is_default});
+    };
+
+    // Sorted by (addr, prefix_len): enclosing prefixes come before nested ones.
+    std::vector<ForwardingTable::Entry> prefixes = effectivePrefixes(ft);
+    std::vector<RouteRange> open;
+    uint64_t cursor = 0;
+
+    for (const auto &p : prefixes)
+    {
+        uint32_t mask = p.prefix_len == 0 ? 0 : 0xFFFFFFFF << (32 - p.prefix_len);
+        RouteRange route{p.addr, p.addr | ~mask, p.iface, false};
+
+        while (!open.empty() && open.back().last < route.first)
+        {
+            emit(cursor, open.back().last, open.back());
+            cursor = open.back().last + 1ULL;
+            open.pop_back();
+        }
+        if (route.first > cursor)
+            emit(cursor, route.first - 1ULL, open.empty() ? background : open.back());
+        cursor = route.first;
+        open.push_back(route);
+    }
+
+    while (!open.empty())
+    {
+        emit(cursor, open.back().last, open.back());
+        cursor = open.back().last + 1ULL;
+        open.pop_back();
+    }
+    emit(cursor, 0xFFFFFFFFULL, background);
+    return ranges;
+}
+
+struct RouteChange
+{
+    uint32_t first;
+    uint32_t last;
+    RouteRange before;
+    RouteRange after;
+};
+
+inline std::vector<RouteChange> diffRanges(const std::vector<RouteRange> &before, const std::vector<RouteRange> &after)
+{
+    std::vector<RouteChange> changes;
+    size_t i = 0, j = 0;
+    uint64_t cursor = 0;
+    while (cursor <= 0xFFFFFFFFULL)
+    {
+        while (before[i].last < cursor)
+            ++i;
+        while (after[j].last < cursor)
+            ++j;
+        uint32_t last = std::min(before[i].last, after[j].last);
+
+        if (!before[i].sameRoute(after[j]))
+        {
+            if (!changes.empty() && changes.back().last + 1ULL == cursor && changes.back().before.sameRoute(before[i]) &&
+                changes.back().after.sameRoute(after[j]))
+                changes.back().last = last;
+            else
+                changes.push_back({static_cast<uint32_t>(cursor), last, before[i], after[j]});
+        }
+        cursor = last + 1ULL;
+    }
+    return changes;
+}
+
+// Returns true if both tables route every address identically; otherwise
+// stores the first differing address in counterexample.
+inline bool verifyEquivalent(const ForwardingTable &a, const ForwardingTable &b, uint32_t &counterexample)
+{
+    std::vector<uint32_t> starts;
+    for (const auto &r : expandToRanges(a))
+        starts.push_back(r.first);
+    for (const auto &r : expandToRanges(b))
+        starts.push_back(r.first);
+    std::sort(starts.begin(), starts.end());
+    starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+
+    for (uint32_t ip : starts)
+    {
+        bool a_default = false, b_default = false;
+        int a_iface = a.lookup(ip, a_default);
+        int b_iface = b.lookup(ip, b_default);
+        if (a_iface != b_iface || a_default != b_default)
+        {
+            counterexample = ip;
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif
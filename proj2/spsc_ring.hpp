@@ -0,0 +1,162 @@
+#ifndef SPSC_RING_HPP
+#define SPSC_RING_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: spsc_ring.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  This class is a bounded lock-free ring buffer for exactly one producer
+ *  thread and one consumer thread, used to connect the stages of the proj2
+ *  simulation pipeline. It also counts how often each side had to wait.
+ *
+ * =============================================================================
+ *  Class: SpscRing<T>
+ *  ---------------------------------------------------------------------------
+ *  - tail_ is written only by the producer and head_ only by the consumer;
+ *    each lives on its own cache line. A push publishes the slot with a
+ *    release store of tail_, and the consumer's acquire load of tail_ makes
+ *    the slot contents visible (and symmetrically for head_).
+ *  - Each side keeps a private copy of the other side's index and only
+ *    reloads the shared one when the copy says the ring is full/empty, so a
+ *    push or pop normally touches no cache line owned by the other thread.
+ *  - push()/pop() block by spinning (with a CPU pause), then yielding.
+ *
+ *  Statistics (each counter is written by one side only and read after the
+ *  threads are joined):
+ *    - push stalls: pushes that found the ring full (consumer too slow).
+ *    - pop stalls:  pops that found the ring empty (producer too slow).
+ *    - occupancy:   number of queued items, sampled at every push.
+ * =============================================================================
+ */
+template <typename T>
+class SpscRing
+{
+public:
+    explicit SpscRing(size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size *= 2;
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    bool tryPush(const T &item)
+    {
+        size_t tail = producer_.tail.load(std::memory_order_relaxed);
+        if (tail - producer_.cached_head == slots_.size())
+        {
+            producer_.cached_head = consumer_.head.load(std::memory_order_acquire);
+            if (tail - producer_.cached_head == slots_.size())
+                return false;
+        }
+        slots_[tail & mask_] = item;
+        producer_.tail.store(tail + 1, std::memory_order_release);
+
+        size_t occupancy = tail + 1 - producer_.cached_head;
+        producer_.occupancy_sum += occupancy;
+        producer_.max_occupancy = std::max(producer_.max_occupancy, occupancy);
+        ++producer_.pushes;
+        return true;
+    }
+
+    bool tryPop(T &item)
+    {
+        size_t head = consumer_.head.load(std::memory_order_relaxed);
+        if (head == consumer_.cached_tail)
+        {
+            consumer_.cached_tail = producer_.tail.load(std::memory_order_acquire);
+            if (head == consumer_.cached_tail)
+                return false;
+        }
+        item = slots_[head & mask_];
+        consumer_.head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    void push(const T &item)
+    {
+        if (tryPush(item))
+            return;
+        ++producer_.stalls;
+        for (unsigned spins = 0; !tryPush(item); ++spins)
+            backoff(spins);
+    }
+
+    T pop()
+    {
+        T item;
+        if (tryPop(item))
+            return item;
+        ++consumer_.stalls;
+        for (unsigned spins = 0; !tryPop(item); ++spins)
+            backoff(spins);
+        return item;
+    }
+
+    size_t capacity() const noexcept { return slots_.size(); }
+    uint64_t pushes() const noexcept { return producer_.pushes; }
+    uint64_t pushStalls() const noexcept { return producer_.stalls; }
+    uint64_t popStalls() const noexcept { return consumer_.stalls; }
+    size_t maxOccupancy() const noexcept { return producer_.max_occupancy; }
+
+    double meanOccupancy() const noexcept
+    {
+        return producer_.pushes == 0 ? 0.0 : static_cast<double>(producer_.occupancy_sum) / producer_.pushes;
+    }
+
+private:
+    struct alignas(64) Producer
+    {
+        std::atomic<size_t> tail{0};
+        size_t cached_head = 0;
+        uint64_t pushes = 0;
+        uint64_t stalls = 0;
+        uint64_t occupancy_sum = 0;
+        size_t max_occupancy = 0;
+    };
+
+    struct alignas(64) Consumer
+    {
+        std::atomic<size_t> head{0};
+        size_t cached_tail = 0;
+        uint64_t stalls = 0;
+    };
+
+    Producer producer_;
+    Consumer consumer_;
+    std::vector<T> slots_;
+    size_t mask_ = 0;
+
+    static void backoff(unsigned spins)
+    {
+        constexpr unsigned SPIN_LIMIT = 64;
+        if (spins < SPIN_LIMIT)
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            _mm_pause();
+#endif
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+};
+
+#endif
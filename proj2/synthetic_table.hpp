@@ -0,0 +1,222 @@
+#ifndef SYNTHETIC_TABLE_HPP
+#define SYNTHETIC_TABLE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "forwarding_table.hpp"
+
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: synthetic_table.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  Generators for synthetic forwarding tables and destination streams used
+ *  to benchmark and cross-check the ForwardingTable lookup engines.
+ *
+ * =============================================================================
+ *  Table generation (generateSyntheticTable):
+ *  Real BGP tables are dominated by /24s, with a long tail of shorter
+ *  prefixes and a handful of host routes, and more-specifics are usually
+ *  carved out of an existing covering block. ForwardingTable only accepts
+ *  /8, /16, /24 and /32, so the BGP length histogram is folded onto those:
+ *
+ *        /8  :  ~0.5%  (capped at the 222 usable unicast blocks)
+ *        /16 : ~14%    (capped at the 56832 usable unicast blocks)
+ *        /24 : ~80%    (absorbs whatever the capped lengths cannot hold)
+ *        /32 : ~5%
+ *
+ *  Each more-specific is placed inside an already generated shorter prefix
+ *  with probability NEST_PROBABILITY, which produces the overlapping chains
+ *  that longest-prefix matching has to resolve. Interfaces follow a skewed
+ *  distribution over 64 ports, about 1% of routes point at interface 0
+ *  (policy drop), and a default route (0.0.0.0/8) is added unless disabled.
+ *
+ *  Destination streams (generateDestinations):
+ *    - Uniform:    independent uniformly random 32-bit addresses.
+ *    - Zipf:       a prefix is drawn with Zipf(s = 1) popularity over a
+ *                  shuffled ranking, then a random host inside it is used.
+ *    - Sequential: consecutive addresses from a random starting point.
+ *    - Hosts:      flow-like traffic: HOST_POOL hosts are drawn as in Zipf,
+ *                  then each destination is one of them, again with
+ *                  Zipf(s = 1) popularity, so destinations repeat.
+ * =============================================================================
+ */
+
+enum class DestPattern
+{
+    Uniform,
+    Zipf,
+    Sequential,
+    Hosts
+};
+
+constexpr size_t HOST_POOL = 1 << 16;
+
+inline const char *destPatternName(DestPattern pattern)
+{
+    switch (pattern)
+    {
+    case DestPattern::Uniform:
+        return "uniform";
+    case DestPattern::Zipf:
+        return "zipf";
+    case DestPattern::Sequential:
+        return "sequential";
+    case DestPattern::Hosts:
+        return "hosts";
+    }
+    return "unknown";
+}
+
+inline uint32_t syntheticPrefixMask(int prefix_len)
+{
+    return prefix_len == 0 ? 0 : 0xFFFFFFFF << (32 - prefix_len);
+}
+
+inline std::vector<ForwardingTable::Entry> generateSyntheticTable(size_t count, uint64_t seed,
+                                                                  bool with_default = true)
+{
+    constexpr double NEST_PROBABILITY = 0.75;
+    // Usable blocks once 0/8, 127/8 and 224/3 are excluded.
+    constexpr size_t MAX_PER_LENGTH[4] = {222, 222u << 8, 222u << 16, SIZE_MAX};
+
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    size_t want[4];
+    want[0] = std::min<size_t>(std::max<size_t>(count / 200, 1), MAX_PER_LENGTH[0]);
+    want[1] = std::min<size_t>(count * 14 / 100, MAX_PER_LENGTH[1]);
+    want[3] = count * 5 / 100;
+    want[2] = count - std::min(count, want[0] + want[1] + want[3]);
+    if (want[2] > MAX_PER_LENGTH[2])
+        throw std::runtime_error("Error: synthetic table size too large (" + std::to_string(count) + ")");
+
+    std::vector<ForwardingTable::Entry> entries;
+    entries.reserve(count + 1);
+    std::unordered_set<uint64_t> seen;
+    seen.reserve(count * 2);
+
+    std::vector<ForwardingTable::Entry> parents;
+    auto pickIface = [&]() -> uint16_t
+    {
+        if (unit(rng) < 0.01)
+            return 0;
+        double u = unit(rng);
+        return static_cast<uint16_t>(1 + static_cast<int>(64.0 * u * u));
+    };
+
+    for (int level = 0; level < 4; ++level)
+    {
+        int plen = 8 * (level + 1);
+        uint32_t mask = syntheticPrefixMask(plen);
+        std::vector<ForwardingTable::Entry> created;
+        created.reserve(want[level]);
+
+        while (created.size() < want[level])
+        {
+            uint32_t addr;
+            if (!parents.empty() && unit(rng) < NEST_PROBABILITY)
+            {
+                const auto &parent = parents[rng() % parents.size()];
+                addr = parent.addr | (static_cast<uint32_t>(rng()) & ~syntheticPrefixMask(parent.prefix_len));
+            }
+            else
+                addr = static_cast<uint32_t>(rng());
+            addr &= mask;
+
+            uint8_t first_octet = addr >> 24;
+            if (first_octet == 0 || first_octet == 127 || first_octet >= 224)
+                continue;
+
+            uint64_t key = (static_cast<uint64_t>(plen) << 32) | addr;
+            if (!seen.insert(key).second)
+                continue;
+
+            entries.push_back({addr, static_cast<uint16_t>(plen), pickIface()});
+            created.push_back(entries.back());
+        }
+        parents.insert(parents.end(), created.begin(), created.end());
+    }
+
+    std::shuffle(entries.begin(), entries.end(), rng);
+    if (with_default)
+        entries.push_back({0, 8, 1});
+    return entries;
+}
+
+inline std::vector<uint32_t> generateDestinations(const std::vector<ForwardingTable::Entry> &entries,
+                                                  DestPattern pattern, size_t count, uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<uint32_t> dests(count);
+
+    switch (pattern)
+    {
+    case DestPattern::Uniform:
+        for (auto &d : dests)
+            d = static_cast<uint32_t>(rng());
+        break;
+
+    case DestPattern::Sequential:
+    {
+        uint32_t start = static_cast<uint32_t>(rng());
+        for (size_t i = 0; i < count; ++i)
+            dests[i] = start + static_cast<uint32_t>(i);
+        break;
+    }
+
+    case DestPattern::Zipf:
+    {
+        std::vector<size_t> ranking(entries.size());
+        for (size_t i = 0; i < ranking.size(); ++i)
+            ranking[i] = i;
+        std::shuffle(ranking.begin(), ranking.end(), rng);
+
+        std::vector<double> cdf(ranking.size());
+        double total = 0.0;
+        for (size_t r = 0; r < cdf.size(); ++r)
+        {
+            total += 1.0 / static_cast<double>(r + 1);
+            cdf[r] = total;
+        }
+
+        std::uniform_real_distribution<double> unit(0.0, total);
+        for (auto &d : dests)
+        {
+            size_t r = std::lower_bound(cdf.begin(), cdf.end(), unit(rng)) - cdf.begin();
+            const auto &e = entries[ranking[std::min(r, ranking.size() - 1)]];
+            uint32_t mask = syntheticPrefixMask(e.prefix_len);
+            d = (e.addr & mask) | (static_cast<uint32_t>(rng()) & ~mask);
+        }
+        break;
+    }
+
+    case DestPattern::Hosts:
+    {
+        std::vector<uint32_t> hosts = generateDestinations(entries, DestPattern::Zipf, HOST_POOL, seed + 1);
+        std::vector<double> cdf(hosts.size());
+        double total = 0.0;
+        for (size_t r = 0; r < cdf.size(); ++r)
+        {
+            total += 1.0 / static_cast<double>(r + 1);
+            cdf[r] = total;
+        }
+
+        std::uniform_real_distribution<double> unit(0.0, total);
+        for (auto &d : dests)
+            d = hosts[std::min<size_t>(std::lower_bound(cdf.begin(), cdf.end(), unit(rng)) - cdf.begin(),
+                                       hosts.size() - 1)];
+        break;
+    }
+    }
+
+    return dests;
+}
+
+#endif
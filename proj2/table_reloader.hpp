@@ -0,0 +1,245 @@
+#ifndef TABLE_RELOADER_HPP
+#define TABLE_RELOADER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include "forwarding_table.hpp"
+
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: table_reloader.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  This class keeps a ForwardingTable in sync with its file while a
+ *  simulation is running. See the details below for how readers and the
+ *  reload thread share tables without locks.
+ *
+ * =============================================================================
+ *  Class: TableReloader
+ *  ---------------------------------------------------------------------------
+ *  Reload thread:
+ *    1. Watches the directory holding the forwarding file with inotify, so
+ *       both in-place rewrites (IN_CLOSE_WRITE) and atomic replacement by
+ *       rename (IN_MOVED_TO) are seen.
+ *    2. Builds a complete new ForwardingTable from the file with the loader
+ *       given at construction (plain load by default). If loading fails the
+ *       error is reported and the current table stays in use.
+ *    3. Publishes the new table with one atomic pointer exchange, then bumps
+ *       the global epoch and retires the old table under that epoch.
+ *
+ *  Readers (quiescent-state-based reclamation):
+ *    - acquire() is a single atomic load; the table it returns is fully
+ *      built because publication happens after construction (release) and
+ *      the load is an acquire.
+ *    - A reader calls quiescent() whenever it holds no table pointer, e.g.
+ *      after each packet. That copies the global epoch into its slot.
+ *    - A retired table is deleted once every registered reader's slot has
+ *      reached its retire epoch: no reader can still be using it.
+ *  Readers never take a lock or wait for the reload thread; only the reload
+ *  thread allocates, frees or touches the retire list.
+ * =============================================================================
+ */
+class TableReloader
+{
+public:
+    static constexpr int MAX_READERS = 8;
+
+    using Loader = std::function<ForwardingTable *(const std::string &)>;
+
+    explicit TableReloader(const std::string &filename, Loader loader = defaultLoader)
+        : filename_(filename), loader_(std::move(loader)), current_(loader_(filename))
+    {
+        for (auto &slot : readers_)
+            slot.epoch.store(IDLE, std::memory_order_relaxed);
+
+        size_t slash = filename_.rfind('/');
+        directory_ = slash == std::string::npos ? "." : filename_.substr(0, slash == 0 ? 1 : slash);
+        basename_ = slash == std::string::npos ? filename_ : filename_.substr(slash + 1);
+
+        inotify_fd_ = inotify_init1(IN_CLOEXEC);
+        stop_fd_ = eventfd(0, EFD_CLOEXEC);
+        if (inotify_fd_ < 0 || stop_fd_ < 0 ||
+            inotify_add_watch(inotify_fd_, directory_.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+        {
+            closeDescriptors();
+            delete current_.load();
+            throw std::runtime_error("Error: cannot watch forwarding file '" + filename_ + "'");
+        }
+
+        watcher_ = std::thread(&TableReloader::watchLoop, this);
+    }
+
+    ~TableReloader()
+    {
+        stop();
+        closeDescriptors();
+
+        for (auto &retired : retired_)
+            delete retired.first;
+        delete current_.load();
+    }
+
+    // Stops and joins the watcher. Afterwards no reload can retire the
+    // current table, so it may be used without a reader slot, and the
+    // reload counters are final.
+    void stop()
+    {
+        if (!watcher_.joinable())
+            return;
+        uint64_t one = 1;
+        if (write(stop_fd_, &one, sizeof(one)) != sizeof(one))
+            std::cerr << "Warning: cannot stop forwarding file watcher\n";
+        watcher_.join();
+    }
+
+    TableReloader(const TableReloader &) = delete;
+    TableReloader &operator=(const TableReloader &) = delete;
+
+    int registerReader()
+    {
+        int slot = next_reader_++;
+        if (slot >= MAX_READERS)
+            throw std::runtime_error("Error: too many forwarding table readers");
+        readers_[slot].epoch.store(epoch_.load(std::memory_order_acquire), std::memory_order_release);
+        return slot;
+    }
+
+    void unregisterReader(int slot)
+    {
+        readers_[slot].epoch.store(IDLE, std::memory_order_release);
+    }
+
+    const ForwardingTable *acquire() const noexcept
+    {
+        return current_.load(std::memory_order_acquire);
+    }
+
+    void quiescent(int slot) noexcept
+    {
+        readers_[slot].epoch.store(epoch_.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    uint64_t reloads() const noexcept { return reloads_.load(std::memory_order_relaxed); }
+    uint64_t failedReloads() const noexcept { return failed_reloads_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint64_t IDLE = UINT64_MAX;
+
+    struct alignas(64) ReaderSlot
+    {
+        std::atomic<uint64_t> epoch;
+    };
+
+    std::string filename_;
+    Loader loader_;
+    std::string directory_;
+    std::string basename_;
+    std::atomic<const ForwardingTable *> current_;
+    std::atomic<uint64_t> epoch_{0};
+    ReaderSlot readers_[MAX_READERS];
+    std::atomic<int> next_reader_{0};
+    std::vector<std::pair<const ForwardingTable *, uint64_t>> retired_;
+    std::atomic<uint64_t> reloads_{0};
+    std::atomic<uint64_t> failed_reloads_{0};
+    int inotify_fd_ = -1;
+    int stop_fd_ = -1;
+    std::thread watcher_;
+
+    static ForwardingTable *defaultLoader(const std::string &filename)
+    {
+        return new ForwardingTable(filename);
+    }
+
+    void closeDescriptors()
+    {
+        if (inotify_fd_ >= 0)
+            close(inotify_fd_);
+        if (stop_fd_ >= 0)
+            close(stop_fd_);
+    }
+
+    void watchLoop()
+    {
+        constexpr int RECLAIM_INTERVAL_MS = 100;
+
+        while (true)
+        {
+            pollfd fds[2] = {{inotify_fd_, POLLIN, 0}, {stop_fd_, POLLIN, 0}};
+            int ready = poll(fds, 2, retired_.empty() ? -1 : RECLAIM_INTERVAL_MS);
+            if (ready < 0 || (fds[1].revents & POLLIN))
+                return;
+
+            if ((fds[0].revents & POLLIN) && fileChanged())
+                reload();
+            reclaim();
+        }
+    }
+
+    bool fileChanged()
+    {
+        alignas(inotify_event) char buffer[4096];
+        ssize_t len = read(inotify_fd_, buffer, sizeof(buffer));
+        bool changed = false;
+        for (ssize_t off = 0; off < len;)
+        {
+            const auto *event = reinterpret_cast<const inotify_event *>(buffer + off);
+            if (event->len > 0 && basename_ == event->name)
+                changed = true;
+            off += sizeof(inotify_event) + event->len;
+        }
+        return changed;
+    }
+
+    void reload()
+    {
+        const ForwardingTable *fresh = nullptr;
+        try
+        {
+            fresh = loader_(filename_);
+        }
+        catch (const std::exception &e)
+        {
+            ++failed_reloads_;
+            std::cerr << "Warning: reload of '" << filename_ << "' failed, keeping previous table ("
+                      << e.what() << ")\n";
+            return;
+        }
+
+        const ForwardingTable *old = current_.exchange(fresh, std::memory_order_acq_rel);
+        uint64_t retire_epoch = epoch_.fetch_add(1, std::memory_order_acq_rel) + 1;
+        retired_.emplace_back(old, retire_epoch);
+        ++reloads_;
+    }
+
+    void reclaim()
+    {
+        uint64_t safe = IDLE;
+        for (const auto &slot : readers_)
+            safe = std::min(safe, slot.epoch.load(std::memory_order_acquire));
+
+        auto keep = retired_.begin();
+        for (auto &retired : retired_)
+        {
+            if (retired.second <= safe)
+                delete retired.first;
+            else
+                *keep++ = retired;
+        }
+        retired_.erase(keep, retired_.end());
+    }
+};
+
+#endif
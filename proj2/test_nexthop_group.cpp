@@ -0,0 +1,77 @@
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: test_nexthop_group.cpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  Checks the bucket maps of NextHopGroup after members go down: no bucket
+ *  may name a down member, and in a resilient group the buckets of the
+ *  surviving members must not move. Run with "make check"; the exit status
+ *  is 1 if any case fails.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "nexthop_group.hpp"
+
+using namespace std;
+
+// The member index of every bucket, through the public select().
+vector<int> bucketOwners(const NextHopGroup &group)
+{
+    vector<int> owners(NextHopGroup::BUCKETS);
+    for (uint32_t b = 0; b < NextHopGroup::BUCKETS; ++b)
+        owners[b] = group.select(static_cast<uint32_t>((static_cast<uint64_t>(b) << 32) / NextHopGroup::BUCKETS));
+    return owners;
+}
+
+bool checkDowns(const string &name, bool resilient, vector<NextHopGroup::Member> members,
+                const vector<uint16_t> &downs)
+{
+    NextHopGroup group(1, resilient, members);
+    for (uint16_t iface : downs)
+    {
+        vector<int> before = bucketOwners(group);
+        if (!group.takeDown(iface))
+        {
+            cout << name << ": FAIL (takeDown " << iface << " refused)\n";
+            return false;
+        }
+        vector<int> after = bucketOwners(group);
+
+        for (uint32_t b = 0; b < NextHopGroup::BUCKETS; ++b)
+        {
+            const NextHopGroup::Member &owner = group.members()[after[b]];
+            if (!owner.up)
+            {
+                cout << name << ": FAIL (bucket " << b << " maps to down iface " << owner.iface
+                     << " after down " << iface << ")\n";
+                return false;
+            }
+            if (resilient && group.members()[before[b]].iface != iface && before[b] != after[b])
+            {
+                cout << name << ": FAIL (bucket " << b << " of a surviving member moved after down "
+                     << iface << ")\n";
+                return false;
+            }
+        }
+    }
+    cout << name << ": ok\n";
+    return true;
+}
+
+int main()
+{
+    bool ok = true;
+    ok &= checkDowns("resilient 4 5 6 7, down 4", true, {{4, 1, true}, {5, 1, true}, {6, 1, true}, {7, 1, true}}, {4});
+    ok &= checkDowns("resilient 4 5 6 7, down 6 then 4", true,
+                     {{4, 1, true}, {5, 1, true}, {6, 1, true}, {7, 1, true}}, {6, 4});
+    ok &= checkDowns("resilient 1:3 2:1 3:5, down 3 then 1", true, {{1, 3, true}, {2, 1, true}, {3, 5, true}}, {3, 1});
+    ok &= checkDowns("resilient 7 members, down 0 1 2 3 4", true,
+                     {{0, 1, true}, {1, 1, true}, {2, 1, true}, {3, 1, true}, {4, 1, true}, {5, 1, true}, {6, 1, true}},
+                     {0, 1, 2, 3, 4});
+    ok &= checkDowns("hash-threshold 4 5 6 7, down 4 then 7", false,
+                     {{4, 1, true}, {5, 1, true}, {6, 1, true}, {7, 1, true}}, {4, 7});
+    return ok ? 0 : 1;
+}
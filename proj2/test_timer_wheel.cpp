@@ -0,0 +1,242 @@
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: test_timer_wheel.cpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  Runs TimerWheel against an ordered multimap of (tick, id) on random
+ *  schedule/advance sequences and checks that both fire the same events at
+ *  the same ticks, in time order. The sequences jump the clock onto and
+ *  around level boundaries (multiples of 256^k) and the fire callback
+ *  schedules follow-up events, some for the tick being fired. Run with
+ *  "make check"; the exit status is 1 if any case fails.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "timer_wheel.hpp"
+
+using namespace std;
+
+using Fired = vector<pair<uint64_t, uint32_t>>;
+
+struct CaseParams
+{
+    uint64_t seed;
+    int steps;
+    // Percent of schedules and advances aimed at a level boundary.
+    int boundary_pct;
+    // Percent of fired events that schedule a follow-up.
+    int follow_pct;
+};
+
+// Ids below FOLLOW_STEP are scheduled by the driver; each follow-up adds
+// FOLLOW_STEP to its parent's id, so ids stay unique, and a chain ends
+// after MAX_FOLLOWS links.
+constexpr uint32_t FOLLOW_STEP = 1u << 28;
+constexpr uint32_t MAX_FOLLOWS = 3;
+
+uint64_t mix(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    return x;
+}
+
+// Whether a fired event schedules a follow-up and how far ahead (0 = the
+// same tick). Depends only on the id, so the wheel and the model agree no
+// matter in which order same-tick events fire.
+bool followUp(uint32_t id, int follow_pct, uint64_t &delay)
+{
+    uint64_t h = mix(id);
+    if (id / FOLLOW_STEP >= MAX_FOLLOWS || static_cast<int>(h % 100) >= follow_pct)
+        return false;
+    switch ((h >> 8) % 4)
+    {
+    case 0:
+        delay = 0;
+        break;
+    case 1:
+        delay = (h >> 16) % 256;
+        break;
+    case 2:
+        delay = (h >> 16) % 65536;
+        break;
+    default:
+        delay = (h >> 16) % (uint64_t{1} << 40);
+        break;
+    }
+    return true;
+}
+
+// The reference: every pending event in a multimap, fired smallest first.
+class Model
+{
+public:
+    uint64_t now = 0;
+    multimap<uint64_t, uint32_t> events;
+
+    void schedule(uint32_t id, uint64_t tick) { events.emplace(max(tick, now), id); }
+
+    void advance(uint64_t tick, int follow_pct, Fired &fired)
+    {
+        while (!events.empty() && events.begin()->first <= tick)
+        {
+            auto [at, id] = *events.begin();
+            events.erase(events.begin());
+            now = at;
+            fired.emplace_back(at, id);
+            uint64_t delay;
+            if (followUp(id, follow_pct, delay))
+                schedule(id + FOLLOW_STEP, at + delay);
+        }
+        now = tick;
+    }
+};
+
+// A tick at, or one either side of, the next multiple of 256^k after now.
+uint64_t nearBoundary(uint64_t now, mt19937_64 &rng)
+{
+    int k = 1 + static_cast<int>(rng() % 6);
+    uint64_t unit = uint64_t{1} << (TimerWheel::SLOT_BITS * k);
+    uint64_t boundary = (now / unit + 1 + rng() % 2) * unit;
+    return boundary - 1 + rng() % 3;
+}
+
+uint64_t randomDelay(mt19937_64 &rng)
+{
+    switch (rng() % 4)
+    {
+    case 0:
+        return rng() % 4;
+    case 1:
+        return rng() % 300;
+    case 2:
+        return rng() % 70000;
+    default:
+        return rng() % (uint64_t{1} << 44);
+    }
+}
+
+// Checks one batch of firings: the wheel's come in time order and are the
+// same (tick, id) pairs as the model's.
+bool sameFirings(const string &name, int step, Fired wheel, Fired model)
+{
+    for (size_t i = 1; i < wheel.size(); ++i)
+        if (wheel[i].first < wheel[i - 1].first)
+        {
+            cout << name << ": FAIL (step " << step << ": tick " << wheel[i].first << " fired after "
+                 << wheel[i - 1].first << ")\n";
+            return false;
+        }
+    sort(wheel.begin(), wheel.end());
+    sort(model.begin(), model.end());
+    if (wheel != model)
+    {
+        cout << name << ": FAIL (step " << step << ": wheel fired " << wheel.size() << " events, model "
+             << model.size() << ")\n";
+        for (size_t i = 0; i < min(wheel.size(), model.size()); ++i)
+            if (wheel[i] != model[i])
+            {
+                cout << "  first difference: wheel id " << wheel[i].second << " at " << wheel[i].first
+                     << ", model id " << model[i].second << " at " << model[i].first << "\n";
+                break;
+            }
+        return false;
+    }
+    return true;
+}
+
+bool checkRandom(const string &name, const CaseParams &params)
+{
+    mt19937_64 rng(params.seed);
+    TimerWheel wheel;
+    Model model;
+    uint32_t next_id = 0;
+
+    Fired wheel_fired, model_fired;
+    auto fire = [&](uint32_t id, uint64_t tick)
+    {
+        wheel_fired.emplace_back(tick, id);
+        uint64_t delay;
+        if (followUp(id, params.follow_pct, delay))
+            wheel.schedule(id + FOLLOW_STEP, tick + delay);
+    };
+
+    for (int step = 0; step < params.steps; ++step)
+    {
+        if (rng() % 3 != 0)
+        {
+            // Schedule a few events: near now, on a boundary, or in the past.
+            for (uint64_t n = 1 + rng() % 4; n > 0 && next_id < FOLLOW_STEP; --n)
+            {
+                uint64_t tick;
+                if (static_cast<int>(rng() % 100) < params.boundary_pct)
+                    tick = nearBoundary(model.now, rng);
+                else if (rng() % 10 == 0)
+                    tick = model.now - min<uint64_t>(model.now, rng() % 1000);
+                else
+                    tick = model.now + randomDelay(rng);
+                wheel.schedule(next_id, tick);
+                model.schedule(next_id, tick);
+                ++next_id;
+            }
+            continue;
+        }
+
+        uint64_t target = static_cast<int>(rng() % 100) < params.boundary_pct ? nearBoundary(model.now, rng)
+                                                                              : model.now + randomDelay(rng);
+        wheel_fired.clear();
+        model_fired.clear();
+        wheel.advance(target, fire);
+        model.advance(target, params.follow_pct, model_fired);
+        if (!sameFirings(name, step, wheel_fired, model_fired))
+            return false;
+        if (wheel.now() != target || wheel.pending() != model.events.size())
+        {
+            cout << name << ": FAIL (step " << step << ": clock " << wheel.now() << " pending " << wheel.pending()
+                 << ", model " << target << " pending " << model.events.size() << ")\n";
+            return false;
+        }
+    }
+
+    // Whatever is left fires on drain, which stops the clock at the last
+    // expiry.
+    wheel_fired.clear();
+    model_fired.clear();
+    wheel.drain(fire);
+    uint64_t last = model.now;
+    model.advance(UINT64_MAX, params.follow_pct, model_fired);
+    if (!model_fired.empty())
+        last = model_fired.back().first;
+    if (!sameFirings(name, params.steps, wheel_fired, model_fired))
+        return false;
+    if (wheel.pending() != 0 || wheel.now() != last)
+    {
+        cout << name << ": FAIL (drain left " << wheel.pending() << " pending, clock " << wheel.now()
+             << " instead of " << last << ")\n";
+        return false;
+    }
+    cout << name << ": ok\n";
+    return true;
+}
+
+int main()
+{
+    bool ok = true;
+    for (uint64_t seed = 1; seed <= 4; ++seed)
+    {
+        string suffix = ", seed " + to_string(seed);
+        ok &= checkRandom("near events" + suffix, {seed, 20000, 0, 0});
+        ok &= checkRandom("level boundary jumps" + suffix, {seed, 20000, 50, 0});
+        ok &= checkRandom("callback schedules" + suffix, {seed, 20000, 20, 40});
+    }
+    return ok ? 0 : 1;
+}
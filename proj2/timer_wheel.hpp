@@ -0,0 +1,223 @@
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: timer_wheel.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  This class is a hierarchical timer wheel: it holds events (a 32-bit id
+ *  and an integer expiry tick) and fires them in time order as the clock is
+ *  advanced, with O(1) scheduling and amortised O(1) expiry per event.
+ *
+ * =============================================================================
+ *  Class: TimerWheel
+ *  ---------------------------------------------------------------------------
+ *  Levels:
+ *    LEVELS wheels of SLOTS = 256 slots each, covering the whole 64-bit
+ *    tick range. An event lives on the lowest level L whose slot range
+ *    still contains both the event and the current time, i.e. the event
+ *    and now agree on every bit above 8 * (L + 1); its slot is bits
+ *    [8L, 8L + 8) of the expiry. So level 0 holds events due within the
+ *    current 256-tick block, level 1 those due within the current 65536-tick
+ *    block, and so on.
+ *
+ *  Advancing:
+ *    When the clock enters the range of a level-L slot, that slot's events
+ *    are cascaded (re-inserted, landing on a lower level). Each event can
+ *    cascade at most LEVELS - 1 times, so the cost per event is constant.
+ *    Idle stretches are skipped: one bitmap per level (256 bits) finds the
+ *    next non-empty slot, and the clock jumps straight to its start instead
+ *    of visiting every tick.
+ *
+ *  Events are nodes in one pool with a free list, so the steady state does
+ *  not allocate. Events due in the same tick fire in no particular order;
+ *  the callback may schedule new events, including for the current tick.
+ * =============================================================================
+ */
+class TimerWheel
+{
+public:
+    static constexpr int LEVELS = 8;
+    static constexpr int SLOT_BITS = 8;
+    static constexpr size_t SLOTS = size_t{1} << SLOT_BITS;
+
+    TimerWheel()
+    {
+        for (auto &level : heads_)
+            for (auto &head : level)
+                head = NIL;
+    }
+
+    uint64_t now() const noexcept { return now_; }
+    size_t pending() const noexcept { return pending_; }
+
+    // An expiry in the past fires at the current tick.
+    void schedule(uint32_t id, uint64_t tick)
+    {
+        if (tick < now_)
+            tick = now_;
+
+        uint32_t node;
+        if (free_ != NIL)
+        {
+            node = free_;
+            free_ = nodes_[node].next;
+        }
+        else
+        {
+            node = static_cast<uint32_t>(nodes_.size());
+            nodes_.push_back({});
+        }
+        nodes_[node].tick = tick;
+        nodes_[node].id = id;
+        link(node);
+        ++pending_;
+    }
+
+    // Fires, in time order, every event due at or before tick (fire(id,
+    // tick) per event) and leaves the clock at tick.
+    template <typename Fn>
+    void advance(uint64_t tick, Fn fire)
+    {
+        if (tick < now_)
+            return;
+        while (true)
+        {
+            fireCurrent(fire);
+            if (now_ == tick)
+                return;
+            uint64_t next = nextEventBound();
+            moveTo(next < tick ? next : tick);
+        }
+    }
+
+    // Fires every pending event; the clock ends at the last expiry.
+    template <typename Fn>
+    void drain(Fn fire)
+    {
+        while (true)
+        {
+            fireCurrent(fire);
+            if (pending_ == 0)
+                return;
+            moveTo(nextEventBound());
+        }
+    }
+
+private:
+    static constexpr uint32_t NIL = 0xFFFFFFFF;
+
+    struct Node
+    {
+        uint64_t tick;
+        uint32_t id;
+        uint32_t next;
+    };
+
+    std::vector<Node> nodes_;
+    uint32_t heads_[LEVELS][SLOTS];
+    uint64_t occupied_[LEVELS][SLOTS / 64] = {};
+    uint32_t free_ = NIL;
+    uint64_t now_ = 0;
+    size_t pending_ = 0;
+
+    static size_t slotOf(uint64_t tick, int level) noexcept
+    {
+        return static_cast<size_t>(tick >> (SLOT_BITS * level)) & (SLOTS - 1);
+    }
+
+    void link(uint32_t node)
+    {
+        uint64_t tick = nodes_[node].tick;
+        int level = 0;
+        while (level < LEVELS - 1 && ((tick ^ now_) >> (SLOT_BITS * (level + 1))) != 0)
+            ++level;
+
+        size_t slot = slotOf(tick, level);
+        nodes_[node].next = heads_[level][slot];
+        heads_[level][slot] = node;
+        occupied_[level][slot / 64] |= uint64_t{1} << (slot % 64);
+    }
+
+    // Detaches and returns the list in a slot.
+    uint32_t takeSlot(int level, size_t slot)
+    {
+        uint32_t head = heads_[level][slot];
+        heads_[level][slot] = NIL;
+        occupied_[level][slot / 64] &= ~(uint64_t{1} << (slot % 64));
+        return head;
+    }
+
+    // Level-0 events in the current slot are exactly those due now.
+    template <typename Fn>
+    void fireCurrent(Fn &fire)
+    {
+        size_t slot = slotOf(now_, 0);
+        while (heads_[0][slot] != NIL)
+        {
+            uint32_t node = takeSlot(0, slot);
+            while (node != NIL)
+            {
+                uint32_t next = nodes_[node].next;
+                uint32_t id = nodes_[node].id;
+                nodes_[node].next = free_;
+                free_ = node;
+                --pending_;
+                fire(id, now_);
+                node = next;
+            }
+        }
+    }
+
+    // Start of the earliest non-empty slot after now; no event is due
+    // before it. UINT64_MAX if nothing is pending.
+    uint64_t nextEventBound() const noexcept
+    {
+        for (int level = 0; level < LEVELS; ++level)
+        {
+            size_t from = slotOf(now_, level) + 1;
+            for (size_t word = from / 64; word < SLOTS / 64; ++word)
+            {
+                uint64_t bits = occupied_[level][word];
+                if (word == from / 64)
+                    bits &= from % 64 == 0 ? ~uint64_t{0} : ~uint64_t{0} << (from % 64);
+                if (bits == 0)
+                    continue;
+
+                uint64_t slot = word * 64 + static_cast<uint64_t>(__builtin_ctzll(bits));
+                int shift = SLOT_BITS * level;
+                uint64_t high = level == LEVELS - 1 ? 0 : (now_ >> (shift + SLOT_BITS)) << (shift + SLOT_BITS);
+                return high | (slot << shift);
+            }
+        }
+        return UINT64_MAX;
+    }
+
+    // Moves the clock forward to tick, which must not pass a pending event,
+    // cascading the slots whose range the clock enters.
+    void moveTo(uint64_t tick)
+    {
+        uint64_t old = now_;
+        now_ = tick;
+        for (int level = LEVELS - 1; level > 0; --level)
+        {
+            if ((old >> (SLOT_BITS * level)) == (tick >> (SLOT_BITS * level)))
+                continue;
+            uint32_t node = takeSlot(level, slotOf(tick, level));
+            while (node != NIL)
+            {
+                uint32_t next = nodes_[node].next;
+                link(node);
+                node = next;
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef TRACE_RECORD_HPP
+#define TRACE_RECORD_HPP
+
+#include <cstdint>
+#include <netinet/ip.h>
+
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: trace_record.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  On-disk layout of one packet trace record as read by proj2: a capture
+ *  timestamp (seconds and microseconds) followed by a bare IPv4 header.
+ *  All fields are in network byte order and records are packed back to
+ *  back with no file header, so record i starts at byte i * sizeof(record).
+ *
+ *  Multi-VRF traces (proj2 -s -V) prefix every record with the id of the
+ *  routing instance the packet arrived on, also in network byte order.
+ */
+
+struct TraceRecord
+{
+    uint32_t sec;
+    uint32_t usec;
+    iphdr hdr;
+};
+
+static_assert(sizeof(TraceRecord) == 28, "trace records must be 28 bytes on disk");
+
+struct VrfTraceRecord
+{
+    uint32_t vrf;
+    TraceRecord record;
+};
+
+static_assert(sizeof(VrfTraceRecord) == 32, "VRF trace records must be 32 bytes on disk");
+
+// The simulator treats a header as intact iff its checksum field equals this.
+inline constexpr uint16_t TRACE_VALID_CHECKSUM = 1234;
+
+#endif
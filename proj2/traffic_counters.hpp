@@ -0,0 +1,155 @@
+#ifndef TRAFFIC_COUNTERS_HPP
+#define TRAFFIC_COUNTERS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "packet_verdict.hpp"
+
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: traffic_counters.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  Live packet and byte counters for proj2 -s, per verdict action and per
+ *  outgoing interface, cheap enough to update for every packet and readable
+ *  at any time by another thread.
+ *
+ * =============================================================================
+ *  Class: TrafficCounters
+ *  ---------------------------------------------------------------------------
+ *  - One Shard per counting thread. Each shard is only ever written by its
+ *    own thread and starts on its own cache line, so counting never moves
+ *    a line between cores.
+ *  - A shard holds a {packets, bytes} pair per drop action and two per
+ *    interface id, one for send and one for default (for all 65536 ids,
+ *    2 MiB per shard, so the hot path needs no bounds check and the table
+ *    never grows under a reader). The send and default totals are summed
+ *    from the interfaces by snapshot(), so a routed packet, the common
+ *    case, costs one counter update rather than two.
+ *  - The counters are atomics written with a relaxed load and store rather
+ *    than an atomic add: with one writer that is an ordinary add, and a
+ *    concurrent snapshot() still reads whole values, never torn ones.
+ *  - snapshot() sums the shards into plain totals on demand. Counts of
+ *    different shards or fields may be a few packets apart in a snapshot
+ *    taken mid-run; once the counting threads have stopped it is exact.
+ * =============================================================================
+ */
+class TrafficCounters
+{
+public:
+    static constexpr size_t ACTIONS = static_cast<size_t>(PacketAction::DropUnknown) + 1;
+    static constexpr size_t IFACES = 65536;
+
+    struct Totals
+    {
+        uint64_t packets = 0;
+        uint64_t bytes = 0;
+    };
+
+    struct Snapshot
+    {
+        // Indexed by PacketAction; PacketAction::Route stays 0.
+        Totals actions[ACTIONS];
+        // Interfaces with any traffic, in increasing id order.
+        std::vector<std::pair<uint16_t, Totals>> ifaces;
+
+        Totals total() const noexcept
+        {
+            Totals sum;
+            for (const Totals &t : actions)
+            {
+                sum.packets += t.packets;
+                sum.bytes += t.bytes;
+            }
+            return sum;
+        }
+    };
+
+    class alignas(64) Shard
+    {
+    public:
+        Shard() : ifaces_(new Counter[IFACES * 2]) {}
+
+        // Counts one packet with its final verdict.
+        void count(PacketVerdict verdict, uint32_t bytes) noexcept
+        {
+            bool fallback = verdict.action == PacketAction::Default;
+            if (verdict.action == PacketAction::Send || fallback)
+                add(ifaces_[verdict.iface * 2 + fallback], bytes);
+            else
+                add(actions_[static_cast<size_t>(verdict.action)], bytes);
+        }
+
+    private:
+        friend class TrafficCounters;
+
+        struct Counter
+        {
+            std::atomic<uint64_t> packets{0};
+            std::atomic<uint64_t> bytes{0};
+        };
+
+        Counter actions_[ACTIONS];
+        std::unique_ptr<Counter[]> ifaces_;
+
+        static void add(Counter &counter, uint32_t bytes) noexcept
+        {
+            counter.packets.store(counter.packets.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            counter.bytes.store(counter.bytes.load(std::memory_order_relaxed) + bytes, std::memory_order_relaxed);
+        }
+
+        static void addTo(Totals &totals, const Counter &counter) noexcept
+        {
+            totals.packets += counter.packets.load(std::memory_order_relaxed);
+            totals.bytes += counter.bytes.load(std::memory_order_relaxed);
+        }
+    };
+
+    explicit TrafficCounters(size_t threads) : shards_(threads) {}
+
+    TrafficCounters(const TrafficCounters &) = delete;
+    TrafficCounters &operator=(const TrafficCounters &) = delete;
+
+    // The shard of counting thread t (0 <= t < threads).
+    Shard &shard(size_t t) noexcept { return shards_[t]; }
+
+    Snapshot snapshot() const
+    {
+        Snapshot snap;
+        for (const Shard &shard : shards_)
+            for (size_t a = 0; a < ACTIONS; ++a)
+                Shard::addTo(snap.actions[a], shard.actions_[a]);
+
+        Totals &sent = snap.actions[static_cast<size_t>(PacketAction::Send)];
+        Totals &defaulted = snap.actions[static_cast<size_t>(PacketAction::Default)];
+        for (size_t iface = 0; iface < IFACES; ++iface)
+        {
+            Totals send, fallback;
+            for (const Shard &shard : shards_)
+            {
+                Shard::addTo(send, shard.ifaces_[iface * 2]);
+                Shard::addTo(fallback, shard.ifaces_[iface * 2 + 1]);
+            }
+            if (send.packets + fallback.packets == 0)
+                continue;
+
+            sent.packets += send.packets;
+            sent.bytes += send.bytes;
+            defaulted.packets += fallback.packets;
+            defaulted.bytes += fallback.bytes;
+            snap.ifaces.emplace_back(static_cast<uint16_t>(iface),
+                                     Totals{send.packets + fallback.packets, send.bytes + fallback.bytes});
+        }
+        return snap;
+    }
+
+private:
+    std::vector<Shard> shards_;
+};
+
+#endif
@@ -0,0 +1,177 @@
+#ifndef VERDICT_FILE_HPP
+#define VERDICT_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "packet_verdict.hpp"
+
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: verdict_file.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  Binary verdict file written by proj2 -s -b and read back by proj2 -c.
+ *
+ * =============================================================================
+ *  Layout
+ *  ---------------------------------------------------------------------------
+ *  A 24-byte VerdictFileHeader followed by 12-byte VerdictRecords, one per
+ *  simulated packet in trace order. Both are written in the byte order of
+ *  the simulating host; byte_order holds 0x01020304 in that order, so a
+ *  reader on the same kind of host can mmap the file and use the records
+ *  in place, and one on the other kind detects it and swaps.
+ *
+ *    header:  magic "P2VD" | version u16 | record_size u16 | byte_order u32
+ *             | reserved u32 | records u64
+ *    record:  sec u32 | usec u32 | action u8 | reserved u8 | iface u16
+ *
+ *  - action is a PacketAction code (1 = drop checksum ... 6 = drop unknown)
+ *    and iface is only meaningful for send (4) and default (5).
+ *  - records is filled in when the writer finishes. It stays 0 if the
+ *    output could not be rewritten (e.g. a pipe); the file size then
+ *    determines the record count.
+ * =============================================================================
+ */
+
+struct VerdictFileHeader
+{
+    char magic[4];
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t byte_order;
+    uint32_t reserved;
+    uint64_t records;
+};
+
+struct VerdictRecord
+{
+    uint32_t sec;
+    uint32_t usec;
+    uint8_t action;
+    uint8_t reserved;
+    uint16_t iface;
+};
+
+static_assert(sizeof(VerdictFileHeader) == 24, "verdict file header must be 24 bytes");
+static_assert(sizeof(VerdictRecord) == 12, "verdict records must be 12 bytes");
+
+inline constexpr char VERDICT_MAGIC[4] = {'P', '2', 'V', 'D'};
+inline constexpr uint16_t VERDICT_VERSION = 1;
+inline constexpr uint32_t VERDICT_BYTE_ORDER = 0x01020304;
+
+inline VerdictFileHeader makeVerdictHeader(uint64_t records)
+{
+    VerdictFileHeader header{};
+    std::memcpy(header.magic, VERDICT_MAGIC, sizeof(header.magic));
+    header.version = VERDICT_VERSION;
+    header.record_size = sizeof(VerdictRecord);
+    header.byte_order = VERDICT_BYTE_ORDER;
+    header.records = records;
+    return header;
+}
+
+// sec and usec in host byte order.
+inline VerdictRecord makeVerdictRecord(uint32_t sec, uint32_t usec, PacketVerdict verdict)
+{
+    return {sec, usec, static_cast<uint8_t>(verdict.action), 0, verdict.iface};
+}
+
+/*
+ * Read-only mmap of a verdict file. Records are returned in host byte order
+ * whichever host wrote them.
+ */
+class VerdictFileReader
+{
+public:
+    explicit VerdictFileReader(const std::string &filename)
+    {
+        int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            throw std::runtime_error("Error: cannot open verdict file '" + filename + "'");
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(VerdictFileHeader))
+        {
+            close(fd);
+            throw std::runtime_error("Error: '" + filename + "' is not a proj2 verdict file");
+        }
+
+        size_ = static_cast<size_t>(st.st_size);
+        void *map = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED)
+            throw std::runtime_error("Error: cannot map verdict file '" + filename + "'");
+        data_ = static_cast<const unsigned char *>(map);
+        madvise(map, size_, MADV_SEQUENTIAL);
+
+        try
+        {
+            readHeader(filename);
+        }
+        catch (...)
+        {
+            munmap(const_cast<unsigned char *>(data_), size_);
+            throw;
+        }
+    }
+
+    ~VerdictFileReader() { munmap(const_cast<unsigned char *>(data_), size_); }
+
+    VerdictFileReader(const VerdictFileReader &) = delete;
+    VerdictFileReader &operator=(const VerdictFileReader &) = delete;
+
+    uint64_t size() const noexcept { return records_; }
+
+    VerdictRecord record(uint64_t i) const noexcept
+    {
+        VerdictRecord r;
+        std::memcpy(&r, data_ + sizeof(VerdictFileHeader) + i * sizeof(VerdictRecord), sizeof(r));
+        if (swapped_)
+        {
+            r.sec = __builtin_bswap32(r.sec);
+            r.usec = __builtin_bswap32(r.usec);
+            r.iface = __builtin_bswap16(r.iface);
+        }
+        return r;
+    }
+
+private:
+    const unsigned char *data_ = nullptr;
+    size_t size_ = 0;
+    uint64_t records_ = 0;
+    bool swapped_ = false;
+
+    void readHeader(const std::string &filename)
+    {
+        VerdictFileHeader header;
+        std::memcpy(&header, data_, sizeof(header));
+        swapped_ = header.byte_order == __builtin_bswap32(VERDICT_BYTE_ORDER);
+        if (swapped_)
+        {
+            header.version = __builtin_bswap16(header.version);
+            header.record_size = __builtin_bswap16(header.record_size);
+            header.records = __builtin_bswap64(header.records);
+        }
+
+        if (std::memcmp(header.magic, VERDICT_MAGIC, sizeof(header.magic)) != 0 ||
+            (header.byte_order != VERDICT_BYTE_ORDER && !swapped_))
+            throw std::runtime_error("Error: '" + filename + "' is not a proj2 verdict file");
+        if (header.version != VERDICT_VERSION || header.record_size != sizeof(VerdictRecord))
+            throw std::runtime_error("Error: unsupported verdict file version " + std::to_string(header.version));
+
+        uint64_t available = (size_ - sizeof(VerdictFileHeader)) / sizeof(VerdictRecord);
+        if (header.records > available)
+            throw std::runtime_error("Error: verdict file '" + filename + "' is truncated");
+        records_ = header.records != 0 ? header.records : available;
+    }
+};
+
+#endif
@@ -0,0 +1,166 @@
+#ifndef VRF_TABLE_HPP
+#define VRF_TABLE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "forwarding_table.hpp"
+#include "huge_pages.hpp"
+#include "route_ranges.hpp"
+
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: vrf_table.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  This class holds the forwarding tables of many routing instances (VRFs)
+ *  in one structure whose identical parts are stored once, so memory grows
+ *  with the differences between VRFs rather than with their number.
+ *
+ * =============================================================================
+ *  Class: VrfForwardingTable
+ *  ---------------------------------------------------------------------------
+ *  Structure:
+ *    Every VRF is a leaf-pushed 256-ary trie with one level per supported
+ *    prefix length (/8, /16, /24, /32). A node is 256 32-bit slots; a slot
+ *    either points to a child node or holds the final lookup result for
+ *    every address under it (leaf pushing copies the result of the longest
+ *    covering prefix down into the slots), so a lookup is at most four
+ *    dependent loads and never backtracks.
+ *
+ *  Sharing (hash-consing):
+ *    Nodes are built bottom-up and interned: a node whose 256 slots equal
+ *    an existing node's reuses that node. Equal subtrees therefore collapse
+ *    to one copy both within a VRF (e.g. many /24s fully covered by the same
+ *    route) and across VRFs. A VRF that differs from another in one /24
+ *    only adds the up-to-four nodes on that path. Nodes are immutable once
+ *    interned, so sharing needs no reference counting or copy-on-write.
+ *
+ *  Slot encoding:
+ *    bit 31 set:      child node index in bits 0-30
+ *    otherwise:       bit 16 = matched a prefix ("send"/"drop policy"),
+ *                     bit 17 = default route, bits 0-15 = iface;
+ *                     0 means no route.
+ *
+ *  Each VRF is loaded and validated by ForwardingTable first, so file
+ *  errors and lookup semantics (including the 0.0.0.0 default quirks) are
+ *  exactly those of a single-table proj2 run.
+ * =============================================================================
+ */
+class VrfForwardingTable
+{
+public:
+    // Starts with no VRFs; a lookup in any VRF finds no route.
+    VrfForwardingTable() = default;
+
+    /*
+     * Adds ft as the next VRF (ids count up from 0). Only its interned
+     * nodes are kept, so ft may be freed right after, and loading VRFs one
+     * at a time never holds more than one ForwardingTable.
+     */
+    void addVrf(const ForwardingTable &ft)
+    {
+        std::vector<ForwardingTable::Entry> prefixes = effectivePrefixes(ft);
+        uint32_t background = ft.hasDefault() ? DEFAULT | static_cast<uint32_t>(ft.getDefault()) : 0;
+        roots_.push_back(build(prefixes, 0, prefixes.size(), 0, background));
+    }
+
+    // Same result convention as ForwardingTable::lookup; an unknown VRF has
+    // no routes at all.
+    int lookup(uint32_t vrf, uint32_t dest_ip, bool &is_default) const
+    {
+        is_default = false;
+        if (vrf >= roots_.size())
+            return -1;
+
+        uint32_t slot = roots_[vrf];
+        for (int shift = 24; slot & CHILD; shift -= 8)
+            slot = nodes_[slot & ~CHILD][(dest_ip >> shift) & 0xFF];
+
+        if (slot & MATCH)
+            return static_cast<int>(slot & 0xFFFF);
+        if (slot & DEFAULT)
+        {
+            is_default = true;
+            return static_cast<int>(slot & 0xFFFF);
+        }
+        return -1;
+    }
+
+    size_t vrfs() const noexcept { return roots_.size(); }
+    size_t nodes() const noexcept { return nodes_.size(); }
+    size_t nodeReferences() const noexcept { return node_references_; }
+    size_t memoryBytes() const noexcept { return nodes_.size() * sizeof(Node); }
+    // What the same tries would take if no node were shared.
+    size_t unsharedBytes() const noexcept { return node_references_ * sizeof(Node); }
+
+private:
+    using Node = std::array<uint32_t, 256>;
+
+    static constexpr uint32_t CHILD = 0x80000000;
+    static constexpr uint32_t DEFAULT = 0x20000;
+    static constexpr uint32_t MATCH = 0x10000;
+
+    std::vector<Node, HugePageAllocator<Node>> nodes_;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> interned_;
+    std::vector<uint32_t> roots_;
+    size_t node_references_ = 0;
+
+    /*
+     * Builds the node for one /(8 * depth) region. prefixes[first, last) are
+     * the prefixes longer than 8 * depth inside the region, sorted by
+     * (address, length); inherited is the result of the longest prefix
+     * covering the whole region.
+     */
+    uint32_t build(const std::vector<ForwardingTable::Entry> &prefixes, size_t first, size_t last,
+                   int depth, uint32_t inherited)
+    {
+        Node node;
+        node.fill(inherited);
+
+        int shift = 24 - 8 * depth;
+        size_t i = first;
+        while (i < last)
+        {
+            uint32_t slot = (prefixes[i].addr >> shift) & 0xFF;
+            uint32_t result = inherited;
+
+            // Sorted by (address, length): an exact /(8 * depth + 8) entry
+            // for this slot comes first, then the longer ones inside it.
+            size_t j = i;
+            if (prefixes[j].prefix_len == 8 * depth + 8)
+                result = MATCH | prefixes[j++].iface;
+            size_t end = j;
+            while (end < last && ((prefixes[end].addr >> shift) & 0xFF) == slot)
+                ++end;
+
+            node[slot] = end > j ? build(prefixes, j, end, depth + 1, result) : result;
+            i = end;
+        }
+        return intern(node);
+    }
+
+    uint32_t intern(const Node &node)
+    {
+        ++node_references_;
+
+        uint64_t hash = 0xCBF29CE484222325ULL;
+        for (uint32_t slot : node)
+            hash = (hash ^ slot) * 0x100000001B3ULL;
+
+        std::vector<uint32_t> &candidates = interned_[hash];
+        for (uint32_t index : candidates)
+            if (nodes_[index] == node)
+                return CHILD | index;
+
+        uint32_t index = static_cast<uint32_t>(nodes_.size());
+        nodes_.push_back(node);
+        candidates.push_back(index);
+        return CHILD | index;
+    }
+};
+
+#endif
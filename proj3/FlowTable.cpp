@@ -0,0 +1,86 @@
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: FlowTable.cpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  This code implements the FlowTable class: a linear-probing index over
+ *  chunked flow storage, doubled and rebuilt from the stored keys whenever
+ *  it would become more than half full, and a sort of flow pointers by key
+ *  for the final output.
+ */
+
+#include "FlowTable.hpp"
+#include <algorithm>
+
+FlowTable::FlowTable() : index_(1024, 0)
+{
+}
+
+size_t FlowTable::hash(const FlowKey &key)
+{
+    uint64_t h = key.hi ^ (key.lo * 0x9E3779B97F4A7C15ULL);
+    h ^= h >> 32;
+    h *= 0xD6E8FEB86659FD93ULL;
+    h ^= h >> 32;
+    return static_cast<size_t>(h);
+}
+
+FlowInfo &FlowTable::findOrInsert(const FlowKey &key, bool &inserted)
+{
+    size_t mask = index_.size() - 1;
+    size_t slot = hash(key) & mask;
+    while (index_[slot] != 0)
+    {
+        Flow &f = flow(index_[slot] - 1);
+        if (f.key == key)
+        {
+            inserted = false;
+            return f.info;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    if ((size_ + 1) * 2 > index_.size())
+    {
+        grow();
+        mask = index_.size() - 1;
+        slot = hash(key) & mask;
+        while (index_[slot] != 0)
+            slot = (slot + 1) & mask;
+    }
+    if ((size_ & (CHUNK - 1)) == 0)
+        chunks_.emplace_back(new Flow[CHUNK]);
+
+    Flow &f = flow(size_);
+    f.key = key;
+    f.info = {};
+    index_[slot] = static_cast<uint32_t>(++size_);
+    inserted = true;
+    return f.info;
+}
+
+void FlowTable::grow()
+{
+    std::vector<uint32_t> index(index_.size() * 2, 0);
+    size_t mask = index.size() - 1;
+    for (size_t n = 0; n < size_; ++n)
+    {
+        size_t slot = hash(flow(n).key) & mask;
+        while (index[slot] != 0)
+            slot = (slot + 1) & mask;
+        index[slot] = static_cast<uint32_t>(n + 1);
+    }
+    index_.swap(index);
+}
+
+std::vector<const Flow *> FlowTable::sorted() const
+{
+    std::vector<const Flow *> flows;
+    flows.reserve(size_);
+    for (size_t n = 0; n < size_; ++n)
+        flows.push_back(&flow(n));
+    std::sort(flows.begin(), flows.end(), [](const Flow *a, const Flow *b)
+              { return a->key < b->key; });
+    return flows;
+}
@@ -0,0 +1,93 @@
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: FlowTable.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  This code declares the FlowTable class, the hash table behind the
+ *  NetFlow mode. Flows are keyed by a five-tuple packed into 16 bytes whose
+ *  numeric order is the five-tuple order, live in fixed-size chunks that
+ *  never move, and are found through an open-addressing index of 32-bit
+ *  flow numbers, so a packet costs one short linear probe and no node
+ *  allocation, and a flow costs about half of a std::map node. The table
+ *  is unordered; sorted() orders it once for printing.
+ */
+
+#ifndef FLOWTABLE_HPP
+#define FLOWTABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// The five-tuple as two words: hi = sip, sport, top half of dip; lo = low
+// half of dip, dport, proto. Comparing (hi, lo) compares the fields in
+// that order.
+struct FlowKey
+{
+    uint64_t hi;
+    uint64_t lo;
+
+    FlowKey() = default;
+    FlowKey(uint32_t sip, uint16_t sport, uint32_t dip, uint16_t dport, char proto)
+        : hi(uint64_t{sip} << 32 | uint64_t{sport} << 16 | dip >> 16),
+          lo(uint64_t{dip & 0xFFFF} << 48 | uint64_t{dport} << 32 | uint64_t{static_cast<uint8_t>(proto)} << 24)
+    {
+    }
+
+    uint32_t sip() const { return static_cast<uint32_t>(hi >> 32); }
+    uint16_t sport() const { return static_cast<uint16_t>(hi >> 16); }
+    uint32_t dip() const { return static_cast<uint32_t>((hi & 0xFFFF) << 16 | lo >> 48); }
+    uint16_t dport() const { return static_cast<uint16_t>(lo >> 32); }
+    char proto() const { return static_cast<char>(lo >> 24); }
+
+    bool operator==(const FlowKey &other) const { return hi == other.hi && lo == other.lo; }
+    bool operator<(const FlowKey &other) const
+    {
+        return hi < other.hi || (hi == other.hi && lo < other.lo);
+    }
+};
+
+struct FlowInfo
+{
+    double first_ts;
+    double last_ts;
+    uint64_t total_pkts;
+    uint64_t total_payload;
+};
+
+struct Flow
+{
+    FlowKey key;
+    FlowInfo info;
+};
+
+class FlowTable
+{
+public:
+    FlowTable();
+
+    // The flow with this key, added with a zeroed FlowInfo (and inserted
+    // set) if it is new. The reference stays valid as the table grows.
+    FlowInfo &findOrInsert(const FlowKey &key, bool &inserted);
+    size_t size() const { return size_; }
+    // Every flow, in key order.
+    std::vector<const Flow *> sorted() const;
+
+    static size_t hash(const FlowKey &key);
+
+private:
+    static constexpr size_t CHUNK_BITS = 12;
+    static constexpr size_t CHUNK = size_t{1} << CHUNK_BITS;
+
+    std::vector<std::unique_ptr<Flow[]>> chunks_;
+    // Flow number + 1 per slot, 0 for empty; kept at most half full.
+    std::vector<uint32_t> index_;
+    size_t size_ = 0;
+
+    Flow &flow(size_t n) const { return chunks_[n >> CHUNK_BITS][n & (CHUNK - 1)]; }
+    void grow();
+};
+
+#endif
@@ -7,8 +7,8 @@
  *  This code implements the FlowTracker class used to generate NetFlow-style
  *  summaries from a packet trace. Each flow is identified by its five-tuple,
  *  and the tracker accumulates total packet count, payload size, and duration.
- *  Once all packets are processed, the aggregated flow data are printed in
- *  the format required for NetFlow mode output.
+ *  Once all packets are processed, the aggregated flow data are sorted by
+ *  five-tuple and printed in the format required for NetFlow mode output.
  */
 
 #include "FlowTracker.hpp"
@@ -21,43 +21,51 @@ void FlowTracker::addPacket(const Packet &p)
     if (!p.isValidForPrint())
         return;
 
-    FlowKey key{p.getSip(), p.getSport(), p.getDip(), p.getDport(), p.getProtoChar()};
-    double ts = p.getTimestamp();
+    FlowKey key(p.getSip(), p.getSport(), p.getDip(), p.getDport(), p.getProtoChar());
+    addPacket(key, p.getTimestamp(), p.getPaylen());
+}
 
-    auto it = flows_.find(key);
-    if (it == flows_.end())
+void FlowTracker::addPacket(const FlowKey &key, double ts, uint16_t paylen)
+{
+    bool inserted;
+    FlowInfo &info = flows_.findOrInsert(key, inserted);
+    if (inserted)
     {
-        flows_[key] = {ts, ts, 1, static_cast<uint64_t>(p.getPaylen())};
+        info = {ts, ts, 1, paylen};
     }
     else
     {
-        FlowInfo &info = it->second;
         info.last_ts = ts;
         info.total_pkts++;
-        info.total_payload += p.getPaylen();
+        info.total_payload += paylen;
     }
 }
 
 void FlowTracker::printFlows() const
 {
-    for (const auto &[key, info] : flows_)
-    {
-        struct in_addr sa{htonl(key.sip)};
-        struct in_addr da{htonl(key.dip)};
-        char ssrc[INET_ADDRSTRLEN];
-        char sdst[INET_ADDRSTRLEN];
-        inet_ntop(AF_INET, &sa, ssrc, sizeof(ssrc));
-        inet_ntop(AF_INET, &da, sdst, sizeof(sdst));
-
-        double duration = info.last_ts - info.first_ts;
-
-        std::cout << ssrc << " " << key.sport << " "
-                  << sdst << " " << key.dport << " "
-                  << key.proto << " "
-                  << std::fixed << std::setprecision(6)
-                  << info.first_ts << " "
-                  << duration << " "
-                  << info.total_pkts << " "
-                  << info.total_payload << "\n";
-    }
+    for (const Flow *flow : flows_.sorted())
+        printFlow(*flow);
+}
+
+void FlowTracker::printFlow(const Flow &flow)
+{
+    const FlowKey &key = flow.key;
+    const FlowInfo &info = flow.info;
+    struct in_addr sa{htonl(key.sip())};
+    struct in_addr da{htonl(key.dip())};
+    char ssrc[INET_ADDRSTRLEN];
+    char sdst[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &sa, ssrc, sizeof(ssrc));
+    inet_ntop(AF_INET, &da, sdst, sizeof(sdst));
+
+    double duration = info.last_ts - info.first_ts;
+
+    std::cout << ssrc << " " << key.sport() << " "
+              << sdst << " " << key.dport() << " "
+              << key.proto() << " "
+              << std::fixed << std::setprecision(6)
+              << info.first_ts << " "
+              << duration << " "
+              << info.total_pkts << " "
+              << info.total_payload << "\n";
 }
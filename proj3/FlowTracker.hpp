@@ -8,48 +8,28 @@
  *  into logical network flows using the five-tuple: source IP, source port,
  *  destination IP, destination port, and protocol. The FlowTracker class
  *  records per-flow statistics including start time, duration, total packets,
- *  and total payload bytes, supporting the NetFlow summary mode of the router
- *  simulator.
+ *  and total payload bytes in a FlowTable, supporting the NetFlow summary mode
+ *  of the router simulator.
  */
 
 #ifndef FLOWTRACKER_HPP
 #define FLOWTRACKER_HPP
 
 #include "Packet.hpp"
-#include <map>
-#include <string>
-
-struct FlowKey
-{
-    uint32_t sip;
-    uint16_t sport;
-    uint32_t dip;
-    uint16_t dport;
-    char proto;
-
-    bool operator<(const FlowKey &other) const
-    {
-        return std::tie(sip, sport, dip, dport, proto) <
-               std::tie(other.sip, other.sport, other.dip, other.dport, other.proto);
-    }
-};
-
-struct FlowInfo
-{
-    double first_ts;
-    double last_ts;
-    uint64_t total_pkts;
-    uint64_t total_payload;
-};
+#include "FlowTable.hpp"
 
 class FlowTracker
 {
 public:
     void addPacket(const Packet &p);
+    void addPacket(const FlowKey &key, double ts, uint16_t paylen);
     void printFlows() const;
+    std::vector<const Flow *> sortedFlows() const { return flows_.sorted(); }
+
+    static void printFlow(const Flow &flow);
 
 private:
-    std::map<FlowKey, FlowInfo> flows_;
+    FlowTable flows_;
 };
 
 #endif
@@ -5,171 +5,127 @@
  * Date created: 2025-10-28
  * Brief description:
  *  This code implements the Packet class, responsible for parsing raw packet
- *  data from the binary trace file. It reconstructs the timestamp from the
- *  capture headers, interprets Ethernet and IPv4 structures, and extracts
- *  transport-layer details for TCP and UDP packets, including sequence and
- *  acknowledgment numbers. The class also determines payload size and provides
- *  formatted printing for packet inspection mode (-p).
+ *  data from the binary trace file in place. Parsing works out where each
+ *  record ends from its Ethernet, IPv4 and TCP/UDP headers; the getters then
+ *  reconstruct the timestamp from the capture headers and extract addresses,
+ *  ports, and sequence and acknowledgment numbers from the record bytes. The
+ *  class also determines payload size and provides formatted printing for
+ *  packet inspection mode (-p).
  */
 
 #include "Packet.hpp"
 
 #include <iostream>
 #include <iomanip>
-#include <cstring>
-#include <vector>
-#include <arpa/inet.h>
 #include <net/ethernet.h>
-#include <netinet/ip.h>
-#include <netinet/udp.h>
-#include <netinet/tcp.h>
+#include <netinet/in.h>
 
 using namespace std;
 
 Packet::Packet()
-    : valid_(false), timestamp_(0.0), ethertype_(0), is_ipv4_(false), sip_(0), dip_(0),
-      ip_len_(0), ip_header_len_(0), ip_proto_(0), sport_(0), dport_(0), proto_char_('\0'),
-      thlen_(0), paylen_(0), seqno_(0), ackno_(0), is_ack_(false)
+    : data_(nullptr), valid_(false), proto_char_('\0'), thlen_(0)
 {
 }
 
-bool Packet::readFully(ifstream &file, char *buf, streamsize n)
-{
-    if (!file.read(buf, n))
-        return false;
-    return true;
-}
-
-bool Packet::readFromStream(ifstream &file)
+size_t Packet::parse(const unsigned char *data, size_t size)
 {
+    data_ = data;
     valid_ = false;
+    proto_char_ = '\0';
+    thlen_ = 0;
 
-    uint32_t sec_n, usec_n;
-    if (!readFully(file, reinterpret_cast<char *>(&sec_n), 4))
-        return false;
-    if (!readFully(file, reinterpret_cast<char *>(&usec_n), 4))
-        return false;
-
-    uint32_t sec = ntohl(sec_n);
-    uint32_t usec = ntohl(usec_n);
-    timestamp_ = static_cast<double>(sec) + static_cast<double>(usec) / 1'000'000.0;
-
-    struct ether_header eth;
-    if (!readFully(file, reinterpret_cast<char *>(&eth), sizeof(eth)))
-        return false;
+    if (size < IP_OFFSET)
+        return 0;
+    if (load16(ETH_OFFSET + 12) != ETHERTYPE_IP)
+        return IP_OFFSET;
 
-    ethertype_ = ntohs(eth.ether_type);
-    if (ethertype_ != ETHERTYPE_IP)
-        return true;
+    if (size < L4_OFFSET)
+        return 0;
+    uint8_t ip_proto = data_[IP_OFFSET + 9];
+    size_t length = L4_OFFSET;
 
-    struct iphdr iph;
-    if (!readFully(file, reinterpret_cast<char *>(&iph), sizeof(iph)))
-        return false;
-
-    ip_proto_ = iph.protocol;
-    ip_len_ = ntohs(iph.tot_len);
-    ip_header_len_ = iph.ihl * 4;
-    sip_ = ntohl(iph.saddr);
-    dip_ = ntohl(iph.daddr);
-    is_ipv4_ = true;
-
-    if (!(ip_proto_ == IPPROTO_TCP || ip_proto_ == IPPROTO_UDP))
-        return true;
-
-    if (ip_proto_ == IPPROTO_UDP)
+    if (ip_proto == IPPROTO_UDP)
     {
-        struct udphdr udph;
-        if (!readFully(file, reinterpret_cast<char *>(&udph), sizeof(udph)))
-            return false;
-
-        sport_ = ntohs(udph.source);
-        dport_ = ntohs(udph.dest);
         proto_char_ = 'U';
-        thlen_ = sizeof(udph);
-        int plen = static_cast<int>(ip_len_) - static_cast<int>(ip_header_len_) - static_cast<int>(thlen_);
-        paylen_ = (plen >= 0) ? plen : 0;
-        seqno_ = 0;
-        ackno_ = 0;
-        is_ack_ = false;
+        thlen_ = 8;
+        length += thlen_;
     }
-    else if (ip_proto_ == IPPROTO_TCP)
+    else if (ip_proto == IPPROTO_TCP)
     {
-        struct tcphdr tcph;
-        if (!readFully(file, reinterpret_cast<char *>(&tcph), sizeof(tcph)))
-            return false;
-
-        uint8_t doff = tcph.th_off ? tcph.th_off : 5;
-        thlen_ = doff * 4;
-        if (thlen_ > 20)
-        {
-            uint16_t optbytes = thlen_ - 20;
-            vector<char> discard(optbytes);
-            if (!readFully(file, discard.data(), optbytes))
-                return false;
-        }
-
-        sport_ = ntohs(tcph.th_sport);
-        dport_ = ntohs(tcph.th_dport);
+        // The fixed header must be there before its data offset is read. A
+        // zero offset is read as the minimum header; options beyond the
+        // fixed 20 bytes are part of the record and skipped.
+        if (size < L4_OFFSET + 20)
+            return 0;
+        uint8_t doff = data_[L4_OFFSET + 12] >> 4;
         proto_char_ = 'T';
-        seqno_ = ntohl(tcph.th_seq);
-        ackno_ = ntohl(tcph.th_ack);
-        is_ack_ = (tcph.th_flags & TH_ACK) != 0;
-        int plen = static_cast<int>(ip_len_) - static_cast<int>(ip_header_len_) - static_cast<int>(thlen_);
-        paylen_ = (plen >= 0) ? plen : 0;
+        thlen_ = (doff ? doff : 5) * 4;
+        length += thlen_ > 20 ? thlen_ : 20;
+    }
+    else
+    {
+        return length;
     }
 
+    if (size < length)
+        return 0;
     valid_ = true;
-    return true;
+    return length;
+}
+
+uint16_t Packet::getPaylen() const
+{
+    int plen = static_cast<int>(getIpLen()) - static_cast<int>((data_[IP_OFFSET] & 0x0F) * 4) - static_cast<int>(thlen_);
+    return static_cast<uint16_t>(plen >= 0 ? plen : 0);
+}
+
+bool Packet::isAck() const
+{
+    return (data_[L4_OFFSET + 13] & 0x10) != 0;
 }
 
 bool Packet::isValidForPrint() const
 {
-    if (!valid_)
-        return false;
-    if (!is_ipv4_)
-        return false;
-    if (!(ip_proto_ == IPPROTO_TCP || ip_proto_ == IPPROTO_UDP))
-        return false;
-    return true;
+    return valid_;
 }
 
 void Packet::printPacket() const
 {
-    cout << fixed << setprecision(6) << timestamp_ << " ";
+    cout << fixed << setprecision(6) << getTimestamp() << " ";
 
     struct in_addr sa{};
-    sa.s_addr = htonl(sip_);
+    sa.s_addr = htonl(getSip());
     char ssrc[INET_ADDRSTRLEN];
     inet_ntop(AF_INET, &sa, ssrc, sizeof(ssrc));
     cout << ssrc << " ";
 
-    cout << sport_ << " ";
+    cout << getSport() << " ";
 
     struct in_addr da{};
-    da.s_addr = htonl(dip_);
+    da.s_addr = htonl(getDip());
     char sdst[INET_ADDRSTRLEN];
     inet_ntop(AF_INET, &da, sdst, sizeof(sdst));
     cout << sdst << " ";
 
-    cout << dport_ << " ";
+    cout << getDport() << " ";
 
-    cout << ip_len_ << " ";
+    cout << getIpLen() << " ";
 
     cout << proto_char_ << " ";
 
     cout << thlen_ << " ";
 
-    cout << paylen_ << " ";
+    cout << getPaylen() << " ";
 
     if (proto_char_ == 'T')
-        cout << seqno_ << " ";
+        cout << getSeqno() << " ";
     else
         cout << "- ";
 
     if (proto_char_ == 'T')
     {
-        if (is_ack_)
-            cout << ackno_;
+        if (isAck())
+            cout << getAckno();
         else
             cout << "-";
     }
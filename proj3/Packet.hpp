@@ -4,64 +4,80 @@
  * Filename: Packet.hpp
  * Date created: 2025-10-28
  * Brief description:
- *  This code declares the Packet class, which encapsulates all relevant
- *  metadata extracted from a single packet in the binary trace file. It
- *  handles reading Ethernet, IPv4, TCP, and UDP headers, storing key
- *  attributes such as timestamps, source and destination addresses, port
- *  numbers, protocol type, header lengths, and payload size. The class also
- *  provides printing and validation methods used by the program’s different
- *  operational modes.
+ *  This code declares the Packet class, a lightweight view of a single
+ *  packet record in the binary trace file. Packet::parse checks the
+ *  Ethernet, IPv4, TCP, and UDP headers of a record in place and keeps a
+ *  pointer to it; attributes such as timestamps, source and destination
+ *  addresses, port numbers, protocol type, header lengths, and payload size
+ *  are decoded from the record bytes when asked for, so parsing neither
+ *  copies nor allocates. The class also provides printing and validation
+ *  methods used by the program’s different operational modes.
  */
 
 #ifndef PACKET_HPP
 #define PACKET_HPP
 
+#include <cstddef>
 #include <cstdint>
-#include <string>
-#include <fstream>
+#include <cstring>
+#include <arpa/inet.h>
 
 class Packet
 {
 public:
     Packet();
 
-    bool readFromStream(std::ifstream &file);
+    // Parses the record at the start of data (size bytes available) and
+    // points this Packet at it. Returns the record's length, or 0 if the
+    // record is cut short by the end of the data. The data must outlive
+    // the Packet.
+    size_t parse(const unsigned char *data, size_t size);
     bool isValidForPrint() const;
     void printPacket() const;
-    double getTimestamp() const { return timestamp_; }
-    uint32_t getSip() const { return sip_; }
-    uint16_t getSport() const { return sport_; }
-    uint32_t getDip() const { return dip_; }
-    uint16_t getDport() const { return dport_; }
+
+    // The getters read the record, so they are only meaningful for a
+    // Packet that isValidForPrint().
+    double getTimestamp() const
+    {
+        return static_cast<double>(load32(0)) + static_cast<double>(load32(4)) / 1'000'000.0;
+    }
+    uint32_t getSip() const { return load32(IP_OFFSET + 12); }
+    uint16_t getSport() const { return load16(L4_OFFSET); }
+    uint32_t getDip() const { return load32(IP_OFFSET + 16); }
+    uint16_t getDport() const { return load16(L4_OFFSET + 2); }
     char getProtoChar() const { return proto_char_; }
-    uint16_t getPaylen() const { return paylen_; }
-    uint32_t getSeqno() const { return seqno_; }
-    uint32_t getAckno() const { return ackno_; }
+    uint16_t getPaylen() const;
+    uint32_t getSeqno() const { return proto_char_ == 'T' ? load32(L4_OFFSET + 4) : 0; }
+    uint32_t getAckno() const { return proto_char_ == 'T' ? load32(L4_OFFSET + 8) : 0; }
 
 private:
-    bool valid_;
-    double timestamp_;
-
-    uint16_t ethertype_;
+    // Record layout: 4-byte seconds, 4-byte microseconds, Ethernet header,
+    // IPv4 header without options, then the transport header.
+    static constexpr size_t ETH_OFFSET = 8;
+    static constexpr size_t IP_OFFSET = ETH_OFFSET + 14;
+    static constexpr size_t L4_OFFSET = IP_OFFSET + 20;
 
-    bool is_ipv4_;
-    uint32_t sip_;
-    uint32_t dip_;
-    uint16_t ip_len_;
-    uint8_t ip_header_len_;
-    uint8_t ip_proto_;
-
-    uint16_t sport_;
-    uint16_t dport_;
+    const unsigned char *data_;
+    bool valid_;
     char proto_char_;
     uint16_t thlen_;
-    int32_t paylen_;
 
-    uint32_t seqno_;
-    uint32_t ackno_;
-    bool is_ack_;
+    uint16_t getIpLen() const { return load16(IP_OFFSET + 2); }
+    bool isAck() const;
+
+    uint32_t load32(size_t offset) const
+    {
+        uint32_t value;
+        std::memcpy(&value, data_ + offset, sizeof(value));
+        return ntohl(value);
+    }
 
-    static bool readFully(std::ifstream &file, char *buf, std::streamsize n);
+    uint16_t load16(size_t offset) const
+    {
+        uint16_t value;
+        std::memcpy(&value, data_ + offset, sizeof(value));
+        return ntohs(value);
+    }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,107 @@
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: ShardedFlowTracker.cpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  This code implements the ShardedFlowTracker class. The shard of a flow
+ *  comes from the high bits of FlowTable::hash, which the per-shard tables
+ *  do not use for their own slots. At the end every worker sorts its own
+ *  flows in parallel, and printFlows merges the sorted lists with a heap;
+ *  the shards hold disjoint flows, so the merge never combines records.
+ */
+
+#include "ShardedFlowTracker.hpp"
+#include <queue>
+#include <utility>
+
+ShardedFlowTracker::ShardedFlowTracker(size_t shards)
+{
+    for (size_t i = 0; i < shards; ++i)
+        shards_.push_back(std::make_unique<Shard>());
+    for (auto &shard : shards_)
+        shard->worker = std::thread(work, std::ref(*shard));
+}
+
+ShardedFlowTracker::~ShardedFlowTracker()
+{
+    finish();
+}
+
+void ShardedFlowTracker::addPacket(const Packet &p)
+{
+    if (!p.isValidForPrint())
+        return;
+
+    FlowKey key(p.getSip(), p.getSport(), p.getDip(), p.getDport(), p.getProtoChar());
+    Shard &shard = *shards_[(FlowTable::hash(key) >> 40) % shards_.size()];
+    if (!shard.open)
+    {
+        shard.open = &shard.queue.beginPush();
+        shard.open->count = 0;
+    }
+
+    shard.open->updates[shard.open->count++] = {key, p.getTimestamp(), p.getPaylen()};
+    if (shard.open->count == BATCH)
+    {
+        shard.queue.endPush();
+        shard.open = nullptr;
+    }
+}
+
+void ShardedFlowTracker::work(Shard &shard)
+{
+    while (true)
+    {
+        FlowBatch &batch = shard.queue.beginPop();
+        if (batch.count == 0)
+            break;
+        for (size_t i = 0; i < batch.count; ++i)
+            shard.tracker.addPacket(batch.updates[i].key, batch.updates[i].ts, batch.updates[i].paylen);
+        shard.queue.endPop();
+    }
+    shard.queue.endPop();
+    shard.sorted = shard.tracker.sortedFlows();
+}
+
+void ShardedFlowTracker::finish()
+{
+    if (finished_)
+        return;
+    finished_ = true;
+
+    for (auto &shard : shards_)
+    {
+        if (shard->open)
+            shard->queue.endPush();
+        shard->queue.beginPush().count = 0;
+        shard->queue.endPush();
+    }
+    for (auto &shard : shards_)
+        shard->worker.join();
+}
+
+void ShardedFlowTracker::printFlows()
+{
+    finish();
+
+    // (next flow, shard) pairs, smallest key on top.
+    using Head = std::pair<const Flow *, size_t>;
+    auto later = [](const Head &a, const Head &b)
+    { return b.first->key < a.first->key; };
+    std::priority_queue<Head, std::vector<Head>, decltype(later)> heads(later);
+    std::vector<size_t> next(shards_.size(), 0);
+
+    for (size_t i = 0; i < shards_.size(); ++i)
+        if (!shards_[i]->sorted.empty())
+            heads.push({shards_[i]->sorted[next[i]++], i});
+
+    while (!heads.empty())
+    {
+        auto [flow, i] = heads.top();
+        heads.pop();
+        FlowTracker::printFlow(*flow);
+        if (next[i] < shards_[i]->sorted.size())
+            heads.push({shards_[i]->sorted[next[i]++], i});
+    }
+}
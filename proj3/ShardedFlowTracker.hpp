@@ -0,0 +1,78 @@
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: ShardedFlowTracker.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  This code declares the ShardedFlowTracker class, a multi-threaded
+ *  replacement for FlowTracker in NetFlow mode (-n -j). Flows are split
+ *  into shards by the hash of their five-tuple; each shard is a FlowTracker
+ *  owned by one worker thread. The thread reading the trace only works out
+ *  each packet's five-tuple and shard and appends it to that shard's batch;
+ *  full batches travel to the worker through an SpscQueue. Every packet of
+ *  a flow lands in the same shard, in trace order, so first_ts, last_ts
+ *  and the counters come out exactly as on one thread, and printFlows only
+ *  has to merge the shards' sorted flow lists.
+ */
+
+#ifndef SHARDEDFLOWTRACKER_HPP
+#define SHARDEDFLOWTRACKER_HPP
+
+#include "Packet.hpp"
+#include "FlowTracker.hpp"
+#include "SpscQueue.hpp"
+#include <memory>
+#include <thread>
+#include <vector>
+
+class ShardedFlowTracker
+{
+public:
+    explicit ShardedFlowTracker(size_t shards);
+    ~ShardedFlowTracker();
+
+    ShardedFlowTracker(const ShardedFlowTracker &) = delete;
+    ShardedFlowTracker &operator=(const ShardedFlowTracker &) = delete;
+
+    // Called from one thread only, like FlowTracker::addPacket.
+    void addPacket(const Packet &p);
+    // Stops the workers and prints every flow, as FlowTracker::printFlows.
+    void printFlows();
+
+private:
+    static constexpr size_t BATCH = 256;
+    static constexpr size_t QUEUE_BATCHES = 64;
+
+    struct FlowUpdate
+    {
+        FlowKey key;
+        double ts;
+        uint16_t paylen;
+    };
+
+    // count == 0 tells the worker the trace has ended.
+    struct FlowBatch
+    {
+        size_t count = 0;
+        FlowUpdate updates[BATCH];
+    };
+
+    struct Shard
+    {
+        Shard() : queue(QUEUE_BATCHES) {}
+
+        SpscQueue<FlowBatch> queue;
+        FlowBatch *open = nullptr;
+        FlowTracker tracker;
+        std::vector<const Flow *> sorted;
+        std::thread worker;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    bool finished_ = false;
+
+    static void work(Shard &shard);
+    void finish();
+};
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: SpscQueue.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  This code defines SpscQueue, a bounded lock-free queue between exactly
+ *  one producer thread and one consumer thread. Items are filled and read
+ *  in place in the queue's own slots (beginPush/endPush, beginPop/endPop),
+ *  so large items such as packet batches are never copied. Only the
+ *  producer writes tail_ and only the consumer writes head_; each side
+ *  keeps a private copy of the other's index and rereads the shared one
+ *  only when the queue looks full or empty. A side that must wait spins
+ *  briefly and then yields its CPU.
+ */
+
+#ifndef SPSCQUEUE_HPP
+#define SPSCQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size *= 2;
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    // The next free slot, waiting for one; endPush() hands it over.
+    T &beginPush()
+    {
+        size_t tail = producer_.tail.load(std::memory_order_relaxed);
+        for (unsigned spins = 0; tail - producer_.cached_head == slots_.size(); ++spins)
+        {
+            producer_.cached_head = consumer_.head.load(std::memory_order_acquire);
+            if (tail - producer_.cached_head == slots_.size())
+                backoff(spins);
+        }
+        return slots_[tail & mask_];
+    }
+
+    void endPush()
+    {
+        producer_.tail.store(producer_.tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // The oldest queued slot, waiting for one; endPop() frees it.
+    T &beginPop()
+    {
+        size_t head = consumer_.head.load(std::memory_order_relaxed);
+        for (unsigned spins = 0; head == consumer_.cached_tail; ++spins)
+        {
+            consumer_.cached_tail = producer_.tail.load(std::memory_order_acquire);
+            if (head == consumer_.cached_tail)
+                backoff(spins);
+        }
+        return slots_[head & mask_];
+    }
+
+    void endPop()
+    {
+        consumer_.head.store(consumer_.head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+private:
+    struct alignas(64) Producer
+    {
+        std::atomic<size_t> tail{0};
+        size_t cached_head = 0;
+    };
+
+    struct alignas(64) Consumer
+    {
+        std::atomic<size_t> head{0};
+        size_t cached_tail = 0;
+    };
+
+    Producer producer_;
+    Consumer consumer_;
+    std::vector<T> slots_;
+    size_t mask_ = 0;
+
+    static void backoff(unsigned spins)
+    {
+        if (spins < 64)
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            _mm_pause();
+#endif
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+};
+
+#endif
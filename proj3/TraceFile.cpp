@@ -0,0 +1,64 @@
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: TraceFile.cpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  This code implements the TraceFile class. The trace is mapped read-only
+ *  with mmap (with a sequential-access hint) when it is a regular non-empty
+ *  file and read into a buffer otherwise; next() then parses the records
+ *  in place, so walking a trace costs no system calls, copies or heap
+ *  allocations per packet.
+ */
+
+#include "TraceFile.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+TraceFile::TraceFile(const std::string &filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+    open_ = true;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        void *map = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED)
+        {
+            madvise(map, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+            map_ = map;
+            size_ = static_cast<size_t>(st.st_size);
+            data_ = static_cast<const unsigned char *>(map);
+            close(fd);
+            return;
+        }
+    }
+
+    unsigned char chunk[1 << 16];
+    ssize_t got;
+    while ((got = read(fd, chunk, sizeof(chunk))) > 0)
+        buffer_.insert(buffer_.end(), chunk, chunk + got);
+    close(fd);
+    size_ = buffer_.size();
+    data_ = buffer_.data();
+}
+
+TraceFile::~TraceFile()
+{
+    if (map_)
+        munmap(map_, size_);
+}
+
+bool TraceFile::next(Packet &p)
+{
+    size_t length = p.parse(data_ + offset_, size_ - offset_);
+    if (length == 0)
+        return false;
+    offset_ += length;
+    return true;
+}
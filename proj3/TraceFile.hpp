@@ -0,0 +1,45 @@
+/**
+ * Name: Shankar Choudhury
+ * Case Network ID: sxc1782
+ * Filename: TraceFile.hpp
+ * Date created: 2026-10-18
+ * Brief description:
+ *  This code declares the TraceFile class, which maps a binary trace file
+ *  into memory and hands out its records one at a time as Packet views
+ *  pointing into the mapping. Files that cannot be mapped (pipes, empty
+ *  files) are read into one buffer instead, so every mode sees the same
+ *  records either way. A record cut short by the end of the file ends the
+ *  trace.
+ */
+
+#ifndef TRACEFILE_HPP
+#define TRACEFILE_HPP
+
+#include "Packet.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class TraceFile
+{
+public:
+    explicit TraceFile(const std::string &filename);
+    ~TraceFile();
+
+    TraceFile(const TraceFile &) = delete;
+    TraceFile &operator=(const TraceFile &) = delete;
+
+    bool isOpen() const { return open_; }
+    // Points p at the next record; false at the end of the trace.
+    bool next(Packet &p);
+
+private:
+    bool open_ = false;
+    void *map_ = nullptr;
+    size_t size_ = 0;
+    size_t offset_ = 0;
+    std::vector<unsigned char> buffer_;
+    const unsigned char *data_ = nullptr;
+};
+
+#endif
@@ -8,17 +8,20 @@
  *   -p : packet printing mode
  *   -n : netflow mode
  *   -s : rount trip time mode
+ *  With -j N, NetFlow mode aggregates on N worker threads, each owning one
+ *  hash shard of the flows (ShardedFlowTracker); the output is the same.
  */
 
 #include <iostream>
 #include <iomanip>
-#include <fstream>
 #include <string>
 #include <cstring>
 #include <cstdlib>
 #include <unistd.h>
 #include "Packet.hpp"
+#include "TraceFile.hpp"
 #include "FlowTracker.hpp"
+#include "ShardedFlowTracker.hpp"
 #include "RTTTracker.hpp"
 
 using namespace std;
@@ -29,21 +32,23 @@ struct CliArgs
     bool netflow_mode = false;
     bool rtt_mode = false;
     string trace_file;
+    size_t workers = 0;
 };
 
 void usage(const char *progname)
 {
-    cerr << "Usage: " << progname << " <-p|-n|-r> -f trace_file\n"
+    cerr << "Usage: " << progname << " <-p|-n|-r> -f trace_file [-j workers]\n"
          << " -p : Packet printing mode (requires -f)\n"
          << " -n : NetFlow mode (requires -f)\n"
-         << " -r : RTT mode (requires -f)\n";
+         << " -r : RTT mode (requires -f)\n"
+         << " -j : Aggregate flows on this many worker threads (with -n)\n";
     exit(EXIT_FAILURE);
 }
 
 void parseArgs(int argc, char *argv[], CliArgs &args)
 {
     int opt;
-    while ((opt = getopt(argc, argv, "pnrf:")) != -1)
+    while ((opt = getopt(argc, argv, "pnrf:j:")) != -1)
     {
         switch (opt)
         {
@@ -59,6 +64,18 @@ void parseArgs(int argc, char *argv[], CliArgs &args)
         case 'f':
             args.trace_file = optarg;
             break;
+        case 'j':
+        {
+            char *end;
+            unsigned long workers = strtoul(optarg, &end, 10);
+            if (*optarg == '\0' || *end != '\0' || workers == 0 || workers > 1024)
+            {
+                cerr << "Error: -j needs a worker count from 1 to 1024\n";
+                usage(argv[0]);
+            }
+            args.workers = workers;
+            break;
+        }
         default:
             usage(argv[0]);
         }
@@ -76,75 +93,81 @@ void parseArgs(int argc, char *argv[], CliArgs &args)
         cerr << "Error: -f trace_file is required\n";
         usage(argv[0]);
     }
+
+    if (args.workers > 0 && !args.netflow_mode)
+    {
+        cerr << "Error: -j is only valid with -n\n";
+        usage(argv[0]);
+    }
 }
 
-void runPacketMode(const string &tracefile)
+void requireOpen(const TraceFile &trace, const string &tracefile)
 {
-    ifstream file(tracefile, ios::binary);
-    if (!file.is_open())
+    if (!trace.isOpen())
     {
         cerr << "Error: Cannot open trace file '" << tracefile << "'\n";
         exit(EXIT_FAILURE);
     }
+}
 
-    while (true)
-    {
-        Packet p;
-        if (!p.readFromStream(file))
-            break;
+void runPacketMode(const string &tracefile)
+{
+    TraceFile trace(tracefile);
+    requireOpen(trace, tracefile);
 
+    Packet p;
+    while (trace.next(p))
+    {
         if (!p.isValidForPrint())
             continue;
 
         p.printPacket();
     }
-
-    file.close();
 }
 
-void runNetflowMode(const std::string &tracefile)
+template <typename Tracker>
+void aggregateFlows(TraceFile &trace, Tracker &tracker)
 {
-    std::ifstream file(tracefile, std::ios::binary);
-    if (!file.is_open())
+    Packet p;
+    while (trace.next(p))
     {
-        std::cerr << "Error: Cannot open trace file '" << tracefile << "'\n";
-        exit(EXIT_FAILURE);
-    }
-
-    FlowTracker tracker;
-    while (true)
-    {
-        Packet p;
-        if (!p.readFromStream(file))
-            break;
         if (!p.isValidForPrint())
             continue;
         tracker.addPacket(p);
     }
-    file.close();
     tracker.printFlows();
 }
 
-void runRTTMode(const std::string &tracefile)
+void runNetflowMode(const std::string &tracefile, size_t workers)
 {
-    std::ifstream file(tracefile, std::ios::binary);
-    if (!file.is_open())
+    TraceFile trace(tracefile);
+    requireOpen(trace, tracefile);
+
+    if (workers > 0)
     {
-        std::cerr << "Error: Cannot open trace file '" << tracefile << "'\n";
-        exit(EXIT_FAILURE);
+        ShardedFlowTracker tracker(workers);
+        aggregateFlows(trace, tracker);
     }
+    else
+    {
+        FlowTracker tracker;
+        aggregateFlows(trace, tracker);
+    }
+}
+
+void runRTTMode(const std::string &tracefile)
+{
+    TraceFile trace(tracefile);
+    requireOpen(trace, tracefile);
 
     RTTTracker tracker;
-    while (true)
+    Packet p;
+    while (trace.next(p))
     {
-        Packet p;
-        if (!p.readFromStream(file))
-            break;
         if (!p.isValidForPrint())
             continue;
         tracker.addPacket(p);
     }
-    file.close();
     tracker.printFlows();
 }
 
@@ -159,7 +182,7 @@ int main(int argc, char *argv[])
     }
     else if (args.netflow_mode)
     {
-        runNetflowMode(args.trace_file);
+        runNetflowMode(args.trace_file, args.workers);
     }
     else if (args.rtt_mode)
     {